@@ -0,0 +1,982 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// gcc -shared -fPIC -O2 -o frame-probe.so frame-probe.c -ldl -lpthread
+//
+// LD_PRELOAD library that measures any of the samples without changing
+// them. It timestamps every presented frame: eglSwapBuffers, the
+// eglSwapBuffersWithDamage extensions handed out by eglGetProcAddress,
+// SDL_GL_SwapWindow and SDL_RenderPresent (an EGL swap made from inside an
+// SDL present is not counted twice). When a process that presented at
+// least one frame exits normally it writes one JSON object to
+// FRAME_PROBE_OUTPUT, or to stderr:
+//
+//   frames, duration_s, fps    presented frames and the time they took
+//   frame_ms                   mean, p50, p90, p99 and max frame interval
+//   startup_ms                 process start to the first frame
+//   startup_phases             where the time before the first frame went
+//   cpu_percent                user + system time over wall time, all threads
+//   rss_kb, peak_rss_kb        resident set size at exit and its peak
+//   width, height, api         the presented surface and how it was presented
+//
+// startup_phases has an entry for every phase the process went through
+// before its first frame: at_ms is when the phase first completed, from
+// process start, and ms the time spent inside it. For loaded that is all
+// the time since exec, for first_swap the time since the latest earlier
+// phase completed. Phases are found by the calls that make them up:
+//
+//   loaded           the probe's constructor ran (exec and dynamic linking)
+//   toolkit_init     SDL_Init, EssContextInit, QGuiApplication's constructor
+//   display_connect  wl_display_connect, xcb_connect, XOpenDisplay
+//   egl_init         eglInitialize
+//   context          eglCreateContext, SDL_GL_CreateContext, SDL_CreateRenderer
+//   assets           IMG_Load, IMG_LoadTexture, TTF_OpenFont
+//   shaders          glCompileShader, glLinkProgram (drivers may defer the
+//                    real compile to the first draw)
+//   first_swap       the first presented frame
+//
+// allocations counts heap allocations (malloc, calloc, realloc and the
+// aligned variants; operator new allocates through malloc) made by the
+// thread that presents frames, so a render loop can be checked to run
+// without allocating once it is warm. The first ALLOC_WARMUP frames
+// (default 60) are not checked. With ALLOC_ASSERT=1 the first frame after
+// them that allocates ends the process with exit status 1, after naming
+// the caller of its first allocation. Allocations made inside the GL
+// driver on that thread count too, those made after the last frame (at
+// shutdown) do not.
+//
+// memory samples RSS (VmRSS) and PSS (smaps_rollup) every
+// MEMORY_INTERVAL_MS (default 1000) from the first frame on, as
+// [seconds, rss_kb, pss_kb], and the growth from the first sample to the
+// last. The interval doubles whenever the sample buffer fills up.
+//
+// With EXIT_AFTER_FIRST_FRAME=1 the report is written and the process
+// exits as soon as the first frame is presented, so startup can be
+// measured over repeated runs.
+//
+// Processes that never present a frame leave FRAME_PROBE_OUTPUT alone.
+// Applications that resolve eglSwapBuffers with dlsym (libepoxy) bypass
+// the probe.
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <EGL/egl.h>
+
+#define MAX_INTERVALS (1 << 18)
+#define MAX_MEMORY_SAMPLES (512)
+
+// glibc's own allocator, which the wrappers below forward to
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+typedef EGLBoolean (*PFN_SWAP)(EGLDisplay, EGLSurface);
+typedef EGLBoolean (*PFN_SWAP_DAMAGE)(EGLDisplay, EGLSurface, EGLint*, EGLint);
+typedef void (*(*PFN_GET_PROC)(const char*))(void);
+typedef int (*PFN_SDL_SWAP)(void*);
+typedef void (*PFN_SDL_PRESENT)(void*);
+typedef void (*PFN_SDL_SIZE)(void*, int*, int*);
+typedef EGLBoolean (*PFN_QUERY_SURFACE)(EGLDisplay, EGLSurface, EGLint, EGLint*);
+typedef EGLBoolean (*PFN_EGL_INITIALIZE)(EGLDisplay, EGLint*, EGLint*);
+typedef EGLContext (*PFN_EGL_CREATE_CONTEXT)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+typedef void (*PFN_GL_SHADER)(unsigned int);
+typedef int (*PFN_SDL_INIT)(unsigned int);
+typedef void *(*PFN_SDL_CREATE_CONTEXT)(void*);
+typedef void *(*PFN_SDL_CREATE_RENDERER)(void*, int, unsigned int);
+typedef void *(*PFN_LOAD)(const char*);
+typedef void *(*PFN_LOAD_TEXTURE)(void*, const char*);
+typedef void *(*PFN_OPEN_FONT)(const char*, int);
+typedef void *(*PFN_CONNECT)(const char*);
+typedef void *(*PFN_XCB_CONNECT)(const char*, int*);
+typedef bool (*PFN_ESS_INIT)(void*);
+typedef void (*PFN_QT_APP)(void*, int*, char**, int);
+
+enum Phase
+{
+   Phase_loaded,
+   Phase_toolkitInit,
+   Phase_displayConnect,
+   Phase_eglInit,
+   Phase_context,
+   Phase_assets,
+   Phase_shaders,
+   Phase_firstSwap,
+   Phase_count
+};
+
+static const char *phaseNames[Phase_count]=
+{
+   "loaded", "toolkit_init", "display_connect", "egl_init",
+   "context", "assets", "shaders", "first_swap"
+};
+
+typedef struct _PhaseTime
+{
+   double atMs;
+   double ms;
+} PhaseTime;
+
+typedef struct _MemorySample
+{
+   float seconds;
+   long rssKb;
+   long pssKb;
+} MemorySample;
+
+static pthread_mutex_t gMutex= PTHREAD_MUTEX_INITIALIZER;
+static __thread int gInSdlPresent= 0;
+static __thread int gPhaseDepth[Phase_count];
+
+static long long gProbeStartUs;
+static double gLoadedMs= -1.0;
+static PhaseTime gPhases[Phase_count];
+static bool gExitAfterFirstFrame= false;
+static bool gReported= false;
+
+static unsigned long gAllocWarmup= 60;
+static bool gAllocAssert= false;
+static pthread_t gRenderThread;
+static bool gHaveRenderThread= false;
+static unsigned long gAllocations= 0;
+static unsigned long gFrameAllocations= 0;
+static unsigned long gSteadyAllocations= 0;
+static unsigned long gAllocatingFrames= 0;
+static unsigned long gMaxFrameAllocations= 0;
+static void *gFirstAllocationSite;
+
+static pthread_t gSampler;
+static long gMemoryIntervalMs= 1000;
+static MemorySample gMemory[MAX_MEMORY_SAMPLES];
+static int gMemoryCount= 0;
+static double gStartupMs= -1.0;
+static long long gFirstFrameUs;
+static long long gLastFrameUs;
+static unsigned long gFrames= 0;
+static float gIntervals[MAX_INTERVALS];
+static int gWidth= 0;
+static int gHeight= 0;
+static const char *gApi= "none";
+
+static PFN_SWAP realSwapBuffers;
+static PFN_SWAP_DAMAGE realSwapWithDamageEXT;
+static PFN_SWAP_DAMAGE realSwapWithDamageKHR;
+static PFN_GL_SHADER realCompileShader;
+static PFN_GL_SHADER realLinkProgram;
+
+static long long monotonicMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ts.tv_sec*1000000LL+ts.tv_nsec/1000LL;
+}
+
+// Milliseconds since the process was started, from the start time in
+// /proc/self/stat (clock tick resolution) and CLOCK_BOOTTIME.
+static double millisSinceProcessStart(void)
+{
+   FILE *stat= fopen("/proc/self/stat", "r");
+   char buffer[1024];
+   unsigned long long startTicks= 0;
+   struct timespec ts;
+   char *p;
+
+   if ( !stat ) return -1.0;
+   if ( !fgets(buffer, sizeof(buffer), stat) )
+   {
+      fclose(stat);
+      return -1.0;
+   }
+   fclose(stat);
+
+   // field 22 is starttime; the command name in field 2 may contain spaces
+   p= strrchr(buffer, ')');
+   if ( !p ) return -1.0;
+   for( int field= 2; field < 22 && p; ++field )
+   {
+      p= strchr(p+1, ' ');
+   }
+   if ( !p ) return -1.0;
+   startTicks= strtoull(p+1, NULL, 10);
+
+   clock_gettime(CLOCK_BOOTTIME, &ts);
+
+   return (ts.tv_sec*1000.0+ts.tv_nsec/1000000.0)-(startTicks*1000.0/sysconf(_SC_CLK_TCK));
+}
+
+// Milliseconds from process start to a monotonic timestamp.
+static double processMillis(long long us)
+{
+   return gLoadedMs+(us-gProbeStartUs)/1000.0;
+}
+
+static long long phaseBegin(enum Phase phase)
+{
+   ++gPhaseDepth[phase];
+   return monotonicMicros();
+}
+
+// Only the outermost call of a phase counts, SDL_GL_CreateContext for
+// example creates its context with eglCreateContext. Calls made after the
+// first frame are not part of startup.
+static void phaseEnd(enum Phase phase, long long start)
+{
+   long long now= monotonicMicros();
+
+   if ( --gPhaseDepth[phase] > 0 ) return;
+
+   pthread_mutex_lock(&gMutex);
+   if ( gFrames == 0 )
+   {
+      if ( gPhases[phase].atMs < 0.0 ) gPhases[phase].atMs= processMillis(now);
+      gPhases[phase].ms += (now-start)/1000.0;
+   }
+   pthread_mutex_unlock(&gMutex);
+}
+
+static void *realFunction(const char *name)
+{
+   void *function= dlsym(RTLD_NEXT, name);
+
+   if ( !function )
+   {
+      fprintf(stderr, "frame-probe: %s not found\n", name);
+   }
+   return function;
+}
+
+// Only the render thread touches the per frame counters.
+static void countAllocation(void *site)
+{
+   __atomic_add_fetch(&gAllocations, 1, __ATOMIC_RELAXED);
+
+   if ( __atomic_load_n(&gHaveRenderThread, __ATOMIC_ACQUIRE) && pthread_equal(pthread_self(), gRenderThread) )
+   {
+      if ( gFrameAllocations++ == 0 ) gFirstAllocationSite= site;
+   }
+}
+
+void *malloc(size_t size)
+{
+   countAllocation(__builtin_return_address(0));
+   return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+   countAllocation(__builtin_return_address(0));
+   return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+   if ( size ) countAllocation(__builtin_return_address(0));
+   return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+   countAllocation(__builtin_return_address(0));
+   return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+   countAllocation(__builtin_return_address(0));
+   return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+   void *result;
+
+   if ( !alignment || (alignment % sizeof(void*)) || (alignment & (alignment-1)) ) return EINVAL;
+
+   countAllocation(__builtin_return_address(0));
+   result= __libc_memalign(alignment, size);
+   if ( !result ) return ENOMEM;
+
+   *ptr= result;
+   return 0;
+}
+
+// Reads "key: value kB" from a /proc file without allocating.
+static long procKb(const char *path, const char *key)
+{
+   char buffer[4096];
+   size_t len= strlen(key);
+   int fd= open(path, O_RDONLY);
+   ssize_t size;
+   char *line;
+
+   if ( fd < 0 ) return -1;
+   size= read(fd, buffer, sizeof(buffer)-1);
+   close(fd);
+   if ( size <= 0 ) return -1;
+   buffer[size]= '\0';
+
+   for( line= buffer; line; line= strchr(line, '\n') )
+   {
+      if ( *line == '\n' ) ++line;
+      if ( !strncmp(line, key, len) && (line[len] == ':') )
+      {
+         return atol(line+len+1);
+      }
+   }
+   return -1;
+}
+
+static void *memorySampler(void *arg)
+{
+   (void)arg;
+
+   for( ;; )
+   {
+      long rssKb= procKb("/proc/self/status", "VmRSS");
+      long pssKb= procKb("/proc/self/smaps_rollup", "Pss");
+      long intervalMs;
+
+      pthread_mutex_lock(&gMutex);
+      if ( gMemoryCount == MAX_MEMORY_SAMPLES )
+      {
+         // keep every other sample and sample half as often
+         for( int i= 0; i < MAX_MEMORY_SAMPLES/2; ++i )
+         {
+            gMemory[i]= gMemory[i*2];
+         }
+         gMemoryCount= MAX_MEMORY_SAMPLES/2;
+         gMemoryIntervalMs *= 2;
+      }
+      gMemory[gMemoryCount].seconds= (monotonicMicros()-gFirstFrameUs)/1000000.0f;
+      gMemory[gMemoryCount].rssKb= rssKb;
+      gMemory[gMemoryCount].pssKb= pssKb;
+      ++gMemoryCount;
+      intervalMs= gMemoryIntervalMs;
+      pthread_mutex_unlock(&gMutex);
+
+      usleep(intervalMs*1000);
+   }
+   return NULL;
+}
+
+static void frameSizeFromEgl(EGLDisplay display, EGLSurface surface)
+{
+   PFN_QUERY_SURFACE querySurface= (PFN_QUERY_SURFACE)dlsym(RTLD_DEFAULT, "eglQuerySurface");
+   EGLint width= 0, height= 0;
+
+   if ( querySurface &&
+        querySurface(display, surface, EGL_WIDTH, &width) &&
+        querySurface(display, surface, EGL_HEIGHT, &height) )
+   {
+      gWidth= width;
+      gHeight= height;
+   }
+}
+
+static void frameSizeFromSdl(const char *function, void *object)
+{
+   PFN_SDL_SIZE getSize= (PFN_SDL_SIZE)dlsym(RTLD_DEFAULT, function);
+
+   if ( getSize )
+   {
+      getSize(object, &gWidth, &gHeight);
+   }
+}
+
+// Records a presented frame; returns true for the first one so the caller
+// can look up the surface size.
+static void writeReport(void);
+
+static void allocationFailure(unsigned long frame, unsigned long allocations, void *site)
+{
+   Dl_info info;
+
+   if ( dladdr(site, &info) && info.dli_sname )
+   {
+      fprintf(stderr, "frame-probe: frame %lu allocated %lu times after warm-up, first from %s (%s+0x%lx)\n",
+              frame, allocations, info.dli_sname, info.dli_fname,
+              (unsigned long)((char*)site-(char*)info.dli_fbase));
+   }
+   else if ( dladdr(site, &info) )
+   {
+      fprintf(stderr, "frame-probe: frame %lu allocated %lu times after warm-up, first from %s+0x%lx\n",
+              frame, allocations, info.dli_fname, (unsigned long)((char*)site-(char*)info.dli_fbase));
+   }
+   else
+   {
+      fprintf(stderr, "frame-probe: frame %lu allocated %lu times after warm-up, first from %p\n",
+              frame, allocations, site);
+   }
+   writeReport();
+   _exit(1);
+}
+
+static int frameDone(const char *api)
+{
+   long long now= monotonicMicros();
+   unsigned long failedFrame= 0, failedAllocations= 0;
+   int first;
+
+   pthread_mutex_lock(&gMutex);
+   first= (gFrames == 0);
+   if ( first )
+   {
+      gFirstFrameUs= now;
+      gStartupMs= processMillis(now);
+      gPhases[Phase_firstSwap].atMs= gStartupMs;
+      gPhases[Phase_firstSwap].ms= gStartupMs;
+      for( int i= 0; i < Phase_firstSwap; ++i )
+      {
+         if ( gPhases[i].atMs >= 0.0 && gStartupMs-gPhases[i].atMs < gPhases[Phase_firstSwap].ms )
+         {
+            gPhases[Phase_firstSwap].ms= gStartupMs-gPhases[i].atMs;
+         }
+      }
+      gApi= api;
+      gRenderThread= pthread_self();
+      __atomic_store_n(&gHaveRenderThread, true, __ATOMIC_RELEASE);
+   }
+   else
+   {
+      gIntervals[(gFrames-1) % MAX_INTERVALS]= (now-gLastFrameUs)/1000.0f;
+   }
+   if ( gFrames >= gAllocWarmup )
+   {
+      gSteadyAllocations += gFrameAllocations;
+      if ( gFrameAllocations ) ++gAllocatingFrames;
+      if ( gFrameAllocations > gMaxFrameAllocations ) gMaxFrameAllocations= gFrameAllocations;
+      if ( gAllocAssert && gFrameAllocations )
+      {
+         failedFrame= gFrames+1;
+         failedAllocations= gFrameAllocations;
+      }
+   }
+   gFrameAllocations= 0;
+   gLastFrameUs= now;
+   ++gFrames;
+   pthread_mutex_unlock(&gMutex);
+
+   if ( failedFrame )
+   {
+      allocationFailure(failedFrame, failedAllocations, gFirstAllocationSite);
+   }
+
+   return first;
+}
+
+static void firstFrameDone(void)
+{
+   if ( gExitAfterFirstFrame )
+   {
+      writeReport();
+      _exit(0);
+   }
+   pthread_create(&gSampler, NULL, memorySampler, NULL);
+}
+
+static EGLBoolean countEglSwap(EGLDisplay display, EGLSurface surface, EGLBoolean result)
+{
+   if ( result && !gInSdlPresent && frameDone("egl") )
+   {
+      frameSizeFromEgl(display, surface);
+      firstFrameDone();
+   }
+   return result;
+}
+
+EGLBoolean eglSwapBuffers(EGLDisplay display, EGLSurface surface)
+{
+   if ( !realSwapBuffers )
+   {
+      realSwapBuffers= (PFN_SWAP)dlsym(RTLD_NEXT, "eglSwapBuffers");
+      if ( !realSwapBuffers ) return EGL_FALSE;
+   }
+   return countEglSwap(display, surface, realSwapBuffers(display, surface));
+}
+
+static EGLBoolean swapWithDamageEXT(EGLDisplay display, EGLSurface surface, EGLint *rects, EGLint count)
+{
+   return countEglSwap(display, surface, realSwapWithDamageEXT(display, surface, rects, count));
+}
+
+static EGLBoolean swapWithDamageKHR(EGLDisplay display, EGLSurface surface, EGLint *rects, EGLint count)
+{
+   return countEglSwap(display, surface, realSwapWithDamageKHR(display, surface, rects, count));
+}
+
+void glCompileShader(unsigned int shader);
+void glLinkProgram(unsigned int program);
+
+void (*eglGetProcAddress(const char *name))(void)
+{
+   static PFN_GET_PROC realGetProcAddress;
+   void (*proc)(void);
+
+   if ( !realGetProcAddress )
+   {
+      realGetProcAddress= (PFN_GET_PROC)dlsym(RTLD_NEXT, "eglGetProcAddress");
+      if ( !realGetProcAddress ) return NULL;
+   }
+
+   proc= realGetProcAddress(name);
+   if ( !proc || !name )
+   {
+      return proc;
+   }
+   if ( !strcmp(name, "eglSwapBuffers") )
+   {
+      if ( !realSwapBuffers ) realSwapBuffers= (PFN_SWAP)proc;
+      return (void (*)(void))eglSwapBuffers;
+   }
+   if ( !strcmp(name, "eglSwapBuffersWithDamageEXT") )
+   {
+      realSwapWithDamageEXT= (PFN_SWAP_DAMAGE)proc;
+      return (void (*)(void))swapWithDamageEXT;
+   }
+   if ( !strcmp(name, "eglSwapBuffersWithDamageKHR") )
+   {
+      realSwapWithDamageKHR= (PFN_SWAP_DAMAGE)proc;
+      return (void (*)(void))swapWithDamageKHR;
+   }
+   if ( !strcmp(name, "glCompileShader") )
+   {
+      realCompileShader= (PFN_GL_SHADER)proc;
+      return (void (*)(void))glCompileShader;
+   }
+   if ( !strcmp(name, "glLinkProgram") )
+   {
+      realLinkProgram= (PFN_GL_SHADER)proc;
+      return (void (*)(void))glLinkProgram;
+   }
+   return proc;
+}
+
+int SDL_GL_SwapWindow(void *window)
+{
+   static PFN_SDL_SWAP realSwapWindow;
+   int result;
+
+   if ( !realSwapWindow )
+   {
+      realSwapWindow= (PFN_SDL_SWAP)dlsym(RTLD_NEXT, "SDL_GL_SwapWindow");
+      if ( !realSwapWindow ) return -1;
+   }
+
+   ++gInSdlPresent;
+   result= realSwapWindow(window);
+   --gInSdlPresent;
+
+   if ( frameDone("sdl-gl") )
+   {
+      frameSizeFromSdl("SDL_GL_GetDrawableSize", window);
+      firstFrameDone();
+   }
+   return result;
+}
+
+void SDL_RenderPresent(void *renderer)
+{
+   static PFN_SDL_PRESENT realRenderPresent;
+
+   if ( !realRenderPresent )
+   {
+      realRenderPresent= (PFN_SDL_PRESENT)dlsym(RTLD_NEXT, "SDL_RenderPresent");
+      if ( !realRenderPresent ) return;
+   }
+
+   ++gInSdlPresent;
+   realRenderPresent(renderer);
+   --gInSdlPresent;
+
+   if ( frameDone("sdl-renderer") )
+   {
+      frameSizeFromSdl("SDL_GetRendererOutputSize", renderer);
+      firstFrameDone();
+   }
+}
+
+static void shaderCall(const char *name, PFN_GL_SHADER *real, unsigned int object)
+{
+   long long start;
+
+   if ( !*real )
+   {
+      *real= (PFN_GL_SHADER)realFunction(name);
+      if ( !*real ) return;
+   }
+
+   start= phaseBegin(Phase_shaders);
+   (*real)(object);
+   phaseEnd(Phase_shaders, start);
+}
+
+void glCompileShader(unsigned int shader)
+{
+   shaderCall("glCompileShader", &realCompileShader, shader);
+}
+
+void glLinkProgram(unsigned int program)
+{
+   shaderCall("glLinkProgram", &realLinkProgram, program);
+}
+
+EGLBoolean eglInitialize(EGLDisplay display, EGLint *major, EGLint *minor)
+{
+   static PFN_EGL_INITIALIZE real;
+   long long start;
+   EGLBoolean result;
+
+   if ( !real && !(real= (PFN_EGL_INITIALIZE)realFunction("eglInitialize")) ) return EGL_FALSE;
+
+   start= phaseBegin(Phase_eglInit);
+   result= real(display, major, minor);
+   phaseEnd(Phase_eglInit, start);
+
+   return result;
+}
+
+EGLContext eglCreateContext(EGLDisplay display, EGLConfig config, EGLContext share, const EGLint *attributes)
+{
+   static PFN_EGL_CREATE_CONTEXT real;
+   long long start;
+   EGLContext result;
+
+   if ( !real && !(real= (PFN_EGL_CREATE_CONTEXT)realFunction("eglCreateContext")) ) return EGL_NO_CONTEXT;
+
+   start= phaseBegin(Phase_context);
+   result= real(display, config, share, attributes);
+   phaseEnd(Phase_context, start);
+
+   return result;
+}
+
+int SDL_Init(unsigned int flags)
+{
+   static PFN_SDL_INIT real;
+   long long start;
+   int result;
+
+   if ( !real && !(real= (PFN_SDL_INIT)realFunction("SDL_Init")) ) return -1;
+
+   start= phaseBegin(Phase_toolkitInit);
+   result= real(flags);
+   phaseEnd(Phase_toolkitInit, start);
+
+   return result;
+}
+
+void *SDL_GL_CreateContext(void *window)
+{
+   static PFN_SDL_CREATE_CONTEXT real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_SDL_CREATE_CONTEXT)realFunction("SDL_GL_CreateContext")) ) return NULL;
+
+   start= phaseBegin(Phase_context);
+   result= real(window);
+   phaseEnd(Phase_context, start);
+
+   return result;
+}
+
+void *SDL_CreateRenderer(void *window, int index, unsigned int flags)
+{
+   static PFN_SDL_CREATE_RENDERER real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_SDL_CREATE_RENDERER)realFunction("SDL_CreateRenderer")) ) return NULL;
+
+   start= phaseBegin(Phase_context);
+   result= real(window, index, flags);
+   phaseEnd(Phase_context, start);
+
+   return result;
+}
+
+void *IMG_Load(const char *file)
+{
+   static PFN_LOAD real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_LOAD)realFunction("IMG_Load")) ) return NULL;
+
+   start= phaseBegin(Phase_assets);
+   result= real(file);
+   phaseEnd(Phase_assets, start);
+
+   return result;
+}
+
+void *IMG_LoadTexture(void *renderer, const char *file)
+{
+   static PFN_LOAD_TEXTURE real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_LOAD_TEXTURE)realFunction("IMG_LoadTexture")) ) return NULL;
+
+   start= phaseBegin(Phase_assets);
+   result= real(renderer, file);
+   phaseEnd(Phase_assets, start);
+
+   return result;
+}
+
+void *TTF_OpenFont(const char *file, int size)
+{
+   static PFN_OPEN_FONT real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_OPEN_FONT)realFunction("TTF_OpenFont")) ) return NULL;
+
+   start= phaseBegin(Phase_assets);
+   result= real(file, size);
+   phaseEnd(Phase_assets, start);
+
+   return result;
+}
+
+static void *connectCall(const char *name, PFN_CONNECT *real, const char *display)
+{
+   long long start;
+   void *result;
+
+   if ( !*real && !(*real= (PFN_CONNECT)realFunction(name)) ) return NULL;
+
+   start= phaseBegin(Phase_displayConnect);
+   result= (*real)(display);
+   phaseEnd(Phase_displayConnect, start);
+
+   return result;
+}
+
+void *wl_display_connect(const char *name)
+{
+   static PFN_CONNECT real;
+
+   return connectCall("wl_display_connect", &real, name);
+}
+
+void *XOpenDisplay(const char *name)
+{
+   static PFN_CONNECT real;
+
+   return connectCall("XOpenDisplay", &real, name);
+}
+
+void *xcb_connect(const char *name, int *screen)
+{
+   static PFN_XCB_CONNECT real;
+   long long start;
+   void *result;
+
+   if ( !real && !(real= (PFN_XCB_CONNECT)realFunction("xcb_connect")) ) return NULL;
+
+   start= phaseBegin(Phase_displayConnect);
+   result= real(name, screen);
+   phaseEnd(Phase_displayConnect, start);
+
+   return result;
+}
+
+bool EssContextInit(void *ctx)
+{
+   static PFN_ESS_INIT real;
+   long long start;
+   bool result;
+
+   if ( !real && !(real= (PFN_ESS_INIT)realFunction("EssContextInit")) ) return false;
+
+   start= phaseBegin(Phase_toolkitInit);
+   result= real(ctx);
+   phaseEnd(Phase_toolkitInit, start);
+
+   return result;
+}
+
+// QGuiApplication::QGuiApplication(int&, char**, int), the same in Qt 5
+// and Qt 6
+void _ZN15QGuiApplicationC1ERiPPci(void *self, int *argc, char **argv, int flags)
+{
+   static PFN_QT_APP real;
+   long long start;
+
+   if ( !real && !(real= (PFN_QT_APP)realFunction("_ZN15QGuiApplicationC1ERiPPci")) ) abort();
+
+   start= phaseBegin(Phase_toolkitInit);
+   real(self, argc, argv, flags);
+   phaseEnd(Phase_toolkitInit, start);
+}
+
+static int compareFloat(const void *a, const void *b)
+{
+   float fa= *(const float*)a, fb= *(const float*)b;
+
+   return (fa > fb)-(fa < fb);
+}
+
+static long statusKb(const char *key)
+{
+   FILE *status= fopen("/proc/self/status", "r");
+   char line[256];
+   size_t len= strlen(key);
+   long kb= -1;
+
+   if ( !status ) return -1;
+   while ( fgets(line, sizeof(line), status) )
+   {
+      if ( !strncmp(line, key, len) && (line[len] == ':') )
+      {
+         kb= atol(line+len+1);
+         break;
+      }
+   }
+   fclose(status);
+
+   return kb;
+}
+
+__attribute__((constructor))
+static void probeInit(void)
+{
+   const char *env= getenv("EXIT_AFTER_FIRST_FRAME");
+
+   gProbeStartUs= monotonicMicros();
+   gLoadedMs= millisSinceProcessStart();
+   for( int i= 0; i < Phase_count; ++i )
+   {
+      gPhases[i].atMs= -1.0;
+   }
+   gPhases[Phase_loaded].atMs= gLoadedMs;
+   gPhases[Phase_loaded].ms= gLoadedMs;
+   gExitAfterFirstFrame= (env && atoi(env));
+
+   env= getenv("ALLOC_WARMUP");
+   if ( env ) gAllocWarmup= strtoul(env, NULL, 10);
+   env= getenv("ALLOC_ASSERT");
+   gAllocAssert= (env && atoi(env));
+   env= getenv("MEMORY_INTERVAL_MS");
+   if ( env && atol(env) > 0 ) gMemoryIntervalMs= atol(env);
+}
+
+static void writeReport(void)
+{
+   const char *path= getenv("FRAME_PROBE_OUTPUT");
+   long long now= monotonicMicros();
+   unsigned long count= (gFrames > 1) ? gFrames-1 : 0;
+   double wallSeconds= (now-gProbeStartUs)/1000000.0;
+   double frameSeconds= (gFrames > 1) ? (gLastFrameUs-gFirstFrameUs)/1000000.0 : 0.0;
+   double mean= 0.0, p50= 0.0, p90= 0.0, p99= 0.0, max= 0.0;
+   double cpuSeconds;
+   struct rusage usage;
+   char phases[1024];
+   int length= 0;
+   FILE *out= stderr;
+
+   // helper processes that inherited LD_PRELOAD (timeout, shells, the
+   // toolkits' own children) drew nothing and must neither replace the
+   // report of the one that did nor clutter stderr
+   if ( gReported || (gFrames == 0) ) return;
+   gReported= true;
+   // the report's own allocations are not the render loop's
+   __atomic_store_n(&gHaveRenderThread, false, __ATOMIC_RELEASE);
+
+   if ( count > MAX_INTERVALS ) count= MAX_INTERVALS;
+   if ( count )
+   {
+      qsort(gIntervals, count, sizeof(float), compareFloat);
+      for( unsigned long i= 0; i < count; ++i ) mean += gIntervals[i];
+      mean /= count;
+      p50= gIntervals[(count-1)*50/100];
+      p90= gIntervals[(count-1)*90/100];
+      p99= gIntervals[(count-1)*99/100];
+      max= gIntervals[count-1];
+   }
+
+   getrusage(RUSAGE_SELF, &usage);
+   cpuSeconds= usage.ru_utime.tv_sec+usage.ru_utime.tv_usec/1000000.0+
+               usage.ru_stime.tv_sec+usage.ru_stime.tv_usec/1000000.0;
+
+   for( int i= 0; i < Phase_count; ++i )
+   {
+      if ( gPhases[i].atMs < 0.0 ) continue;
+      length += snprintf(phases+length, sizeof(phases)-length, "%s\"%s\": {\"at_ms\": %.1f, \"ms\": %.1f}",
+                         length ? ", " : "", phaseNames[i], gPhases[i].atMs, gPhases[i].ms);
+   }
+   phases[length]= '\0';
+
+   if ( path && *path )
+   {
+      out= fopen(path, "w");
+      if ( !out ) return;
+   }
+
+   fprintf(out,
+           "{\"frames\": %lu, \"duration_s\": %.3f, \"fps\": %.2f, "
+           "\"frame_ms\": {\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+           "\"startup_ms\": %.1f, \"startup_phases\": {%s}, \"cpu_percent\": %.1f, \"rss_kb\": %ld, \"peak_rss_kb\": %ld, "
+           "\"width\": %d, \"height\": %d, \"api\": \"%s\", ",
+           gFrames, frameSeconds, (frameSeconds > 0.0) ? (gFrames-1)/frameSeconds : 0.0,
+           mean, p50, p90, p99, max,
+           gStartupMs, phases, (wallSeconds > 0.0) ? 100.0*cpuSeconds/wallSeconds : 0.0,
+           statusKb("VmRSS"), statusKb("VmHWM"),
+           gWidth, gHeight, gApi);
+
+   fprintf(out,
+           "\"allocations\": {\"total\": %lu, \"warmup_frames\": %lu, \"steady\": %lu, "
+           "\"allocating_frames\": %lu, \"max_per_frame\": %lu}, ",
+           __atomic_load_n(&gAllocations, __ATOMIC_RELAXED), gAllocWarmup, gSteadyAllocations,
+           gAllocatingFrames, gMaxFrameAllocations);
+
+   pthread_mutex_lock(&gMutex);
+   fprintf(out, "\"memory\": {\"interval_ms\": %ld, \"rss_growth_kb\": %ld, \"pss_growth_kb\": %ld, \"samples\": [",
+           gMemoryIntervalMs,
+           gMemoryCount ? gMemory[gMemoryCount-1].rssKb-gMemory[0].rssKb : 0,
+           gMemoryCount ? gMemory[gMemoryCount-1].pssKb-gMemory[0].pssKb : 0);
+   for( int i= 0; i < gMemoryCount; ++i )
+   {
+      fprintf(out, "%s[%.1f, %ld, %ld]", i ? ", " : "", gMemory[i].seconds, gMemory[i].rssKb, gMemory[i].pssKb);
+   }
+   pthread_mutex_unlock(&gMutex);
+   fprintf(out, "]}}\n");
+
+   if ( out != stderr ) fclose(out);
+}
+
+__attribute__((destructor))
+static void probeExit(void)
+{
+   writeReport();
+}
@@ -0,0 +1,143 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// gcc -o input-inject input-inject.c
+//
+// Creates a virtual keyboard through /dev/uinput and presses arrow keys at a
+// fixed interval, so input latency can be measured without a person at the
+// remote. Needs write access to /dev/uinput and a compositor (Westeros,
+// weston with the drm backend, Essos direct mode) that reads evdev devices.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+
+static const int keys[] = { KEY_RIGHT, KEY_DOWN, KEY_LEFT, KEY_UP };
+
+static void usage(const char *name)
+{
+   printf("usage: %s [-n presses] [-i interval-ms] [-d settle-ms]\n", name);
+   printf("  -n  number of key presses (default 100)\n");
+   printf("  -i  time between presses in ms (default 250)\n");
+   printf("  -d  time to wait for the device to be picked up in ms (default 1000)\n");
+}
+
+static void sleepMillis(int ms)
+{
+   struct timespec ts;
+
+   ts.tv_sec= ms/1000;
+   ts.tv_nsec= (ms%1000)*1000000L;
+   while ( (nanosleep(&ts, &ts) == -1) && (errno == EINTR) );
+}
+
+static int emit(int fd, int type, int code, int value)
+{
+   struct input_event ev;
+
+   memset(&ev, 0, sizeof(ev));
+   ev.type= type;
+   ev.code= code;
+   ev.value= value;
+
+   return (write(fd, &ev, sizeof(ev)) == sizeof(ev)) ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+   int presses= 100;
+   int intervalMs= 250;
+   int settleMs= 1000;
+   struct uinput_setup setup;
+   int opt, fd;
+
+   while ( (opt= getopt(argc, argv, "n:i:d:h")) != -1 )
+   {
+      switch( opt )
+      {
+         case 'n':
+            presses= atoi(optarg);
+            break;
+         case 'i':
+            intervalMs= atoi(optarg);
+            break;
+         case 'd':
+            settleMs= atoi(optarg);
+            break;
+         default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 1;
+      }
+   }
+
+   fd= open("/dev/uinput", O_WRONLY|O_NONBLOCK);
+   if ( fd < 0 )
+   {
+      fprintf(stderr, "input-inject: unable to open /dev/uinput: %s\n", strerror(errno));
+      return 1;
+   }
+
+   ioctl(fd, UI_SET_EVBIT, EV_KEY);
+   for( size_t i= 0; i < sizeof(keys)/sizeof(keys[0]); ++i )
+   {
+      ioctl(fd, UI_SET_KEYBIT, keys[i]);
+   }
+
+   memset(&setup, 0, sizeof(setup));
+   setup.id.bustype= BUS_VIRTUAL;
+   setup.id.vendor= 0x1d6b;
+   setup.id.product= 0xdac0;
+   snprintf(setup.name, UINPUT_MAX_NAME_SIZE, "dac-examples input-inject");
+
+   if ( (ioctl(fd, UI_DEV_SETUP, &setup) < 0) || (ioctl(fd, UI_DEV_CREATE) < 0) )
+   {
+      fprintf(stderr, "input-inject: unable to create uinput device: %s\n", strerror(errno));
+      close(fd);
+      return 1;
+   }
+
+   // give udev and the compositor time to open the new device
+   sleepMillis(settleMs);
+
+   for( int i= 0; i < presses; ++i )
+   {
+      int key= keys[i % (sizeof(keys)/sizeof(keys[0]))];
+
+      if ( (emit(fd, EV_KEY, key, 1) < 0) || (emit(fd, EV_SYN, SYN_REPORT, 0) < 0) ||
+           (emit(fd, EV_KEY, key, 0) < 0) || (emit(fd, EV_SYN, SYN_REPORT, 0) < 0) )
+      {
+         fprintf(stderr, "input-inject: write failed: %s\n", strerror(errno));
+         break;
+      }
+      sleepMillis(intervalMs);
+   }
+
+   printf("input-inject: sent %d key presses\n", presses);
+
+   ioctl(fd, UI_DEV_DESTROY);
+   close(fd);
+
+   return 0;
+}
@@ -0,0 +1,66 @@
+#!/bin/sh
+#
+# If not stated otherwise in this file or this component's Licenses.txt file the
+# following copyright and licenses apply:
+#
+# Copyright 2026 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Runs a sample (wayland-input, essos-sample) while input-inject presses
+# keys, then stops it with SIGINT so it prints its input latency histogram.
+#
+#   input-latency.sh [-n presses] [-i interval-ms] [-s startup-s] -- app [args]
+
+PRESSES=100
+INTERVAL=250
+STARTUP=2
+INJECT=${INJECT:-$(dirname "$0")/input-inject}
+
+while getopts "n:i:s:" opt; do
+	case $opt in
+		n) PRESSES=$OPTARG ;;
+		i) INTERVAL=$OPTARG ;;
+		s) STARTUP=$OPTARG ;;
+		*) echo "usage: $0 [-n presses] [-i interval-ms] [-s startup-s] -- app [args]"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+	echo "usage: $0 [-n presses] [-i interval-ms] [-s startup-s] -- app [args]"
+	exit 1
+fi
+
+LOG=$(mktemp)
+"$@" > "$LOG" 2>&1 &
+APP=$!
+
+sleep "$STARTUP"
+if ! kill -0 $APP 2>/dev/null; then
+	echo "$1 exited during startup:"
+	cat "$LOG"
+	rm -f "$LOG"
+	exit 1
+fi
+
+"$INJECT" -n "$PRESSES" -i "$INTERVAL"
+RC=$?
+
+kill -INT $APP
+wait $APP
+
+sed -n '/^input latency:/,$p' "$LOG"
+rm -f "$LOG"
+exit $RC
@@ -0,0 +1,257 @@
+#!/bin/sh
+#
+# If not stated otherwise in this file or this component's Licenses.txt file the
+# following copyright and licenses apply:
+#
+# Copyright 2026 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Builds every sample whose dependencies are installed, runs each one for
+# the same time at the same requested resolution with frame-probe.so
+# preloaded, and merges the probe reports into one JSON file. Samples that
+# cannot be built or run are listed with a status and a reason.
+#
+#   run-benchmarks.sh [-d seconds] [-s WxH] [-b build-dir] [-o report.json] [-H] [-S runs] [sample ...]
+#
+# -H runs headless: the EGL samples on a pbuffer (BACKEND=pbuffer), Qt on
+# the offscreen platform and SDL on its offscreen driver.
+#
+# The SDL samples are built with the top-level CMake project; CMAKE_ARGS is
+# passed to it, e.g. CMAKE_ARGS="-DDAC_LTO=ON -DDAC_MCPU=cortex-a53".
+#
+# -S also starts every sample the given number of times with
+# EXIT_AFTER_FIRST_FRAME=1 and adds each run's time to first frame to its
+# report as startup_runs_ms.
+
+SAMPLES_ALL="essos-sample essos-egl wayland-egl qt-egl-test qt-quick-test sdl-test sdl-game-test"
+DURATION=10
+SIZE=1280x720
+BUILD=$PWD/benchmark-build
+REPORT=benchmark-report.json
+HEADLESS=0
+STARTUP_RUNS=0
+SRC=$(cd "$(dirname "$0")/.." && pwd)
+USAGE="usage: $0 [-d seconds] [-s WxH] [-b build-dir] [-o report.json] [-H] [-S runs] [sample ...]"
+
+while getopts "d:s:b:o:HS:" opt; do
+	case $opt in
+		d) DURATION=$OPTARG ;;
+		s) SIZE=$OPTARG ;;
+		b) BUILD=$OPTARG ;;
+		o) REPORT=$OPTARG ;;
+		H) HEADLESS=1 ;;
+		S) STARTUP_RUNS=$OPTARG ;;
+		*) echo "$USAGE"; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+SAMPLES=${*:-$SAMPLES_ALL}
+WIDTH=${SIZE%x*}
+HEIGHT=${SIZE#*x}
+mkdir -p "$BUILD/results" || exit 1
+BUILD=$(cd "$BUILD" && pwd)
+RESULTS=$BUILD/results
+rm -f "$RESULTS"/*
+
+# skip sample reason: the sample is reported instead of run
+skip() {
+	echo "$2" > "$RESULTS/$1.skip"
+	echo "$1: skipped, $2"
+}
+
+wanted() {
+	case " $SAMPLES " in
+		*" $1 "*) return 0 ;;
+	esac
+	return 1
+}
+
+have_pkgs() {
+	pkg-config --exists "$@" 2>/dev/null
+}
+
+build_probe() {
+	gcc -shared -fPIC -O2 -o "$BUILD/frame-probe.so" "$SRC/benchmark/frame-probe.c" -ldl -lpthread
+}
+
+build_wayland_egl() {
+	if ! have_pkgs wayland-client wayland-egl glesv2 egl; then
+		skip wayland-egl "wayland-client, wayland-egl, glesv2 or egl not found"
+		return
+	fi
+	gcc -O2 -o "$BUILD/wayland-egl" "$SRC/wayland-egl-test/wayland-egl.c" \
+		$(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl) \
+		> "$BUILD/wayland-egl.build.log" 2>&1 ||
+		skip wayland-egl "build failed, see $BUILD/wayland-egl.build.log"
+}
+
+build_essos() {
+	rm -rf "$BUILD/essos-test"
+	cp -r "$SRC/essos-test" "$BUILD/essos-test"
+	if ! (cd "$BUILD/essos-test" && autoreconf -fi && ./configure && make) \
+		> "$BUILD/essos-test.build.log" 2>&1; then
+		skip essos-sample "build failed, see $BUILD/essos-test.build.log"
+		skip essos-egl "build failed, see $BUILD/essos-test.build.log"
+	fi
+}
+
+build_qt() {
+	QMAKE=$(command -v qmake || command -v qmake-qt5 || command -v qmake6)
+	if [ -z "$QMAKE" ]; then
+		skip "$1" "qmake not found"
+		return
+	fi
+	mkdir -p "$BUILD/$1"
+	(cd "$BUILD/$1" && "$QMAKE" "$SRC/qt-egl-test/$1.pro" && make) \
+		> "$BUILD/$1.build.log" 2>&1 ||
+		skip "$1" "build failed, see $BUILD/$1.build.log"
+}
+
+build_sdl() {
+	if ! command -v cmake > /dev/null; then
+		skip sdl-test "cmake not found"
+		skip sdl-game-test "cmake not found"
+		return
+	fi
+	# CMake leaves out the samples whose SDL packages are missing
+	cmake -S "$SRC" -B "$BUILD/cmake" $CMAKE_ARGS > "$BUILD/sdl.build.log" 2>&1
+	for sample in sdl-test sdl-game-test; do
+		wanted $sample || continue
+		cmake --build "$BUILD/cmake" --target $sample >> "$BUILD/sdl.build.log" 2>&1 ||
+			skip $sample "not built, see $BUILD/sdl.build.log"
+	done
+}
+
+# run sample [VAR=value ...] program: runs it for DURATION seconds and
+# stops it with SIGINT so the probe writes its report at exit
+run() {
+	name=$1
+	shift
+	[ -f "$RESULTS/$name.skip" ] && return
+	echo "$name: running for $DURATION s"
+
+	env WIDTH="$WIDTH" HEIGHT="$HEIGHT" FRAME_PROBE_OUTPUT="$RESULTS/$name.json" \
+		LD_PRELOAD="$BUILD/frame-probe.so" "$@" > "$RESULTS/$name.log" 2>&1 &
+	pid=$!
+
+	sleep "$DURATION"
+	if ! kill -0 $pid 2>/dev/null; then
+		wait $pid
+		echo "exited after less than $DURATION s with status $?, see $RESULTS/$name.log" > "$RESULTS/$name.error"
+		return
+	fi
+
+	kill -INT $pid
+	waited=0
+	while kill -0 $pid 2>/dev/null && [ $waited -lt 5 ]; do
+		sleep 1
+		waited=$((waited + 1))
+	done
+	if kill -0 $pid 2>/dev/null; then
+		kill -KILL $pid
+		echo "did not exit on SIGINT, see $RESULTS/$name.log" > "$RESULTS/$name.error"
+	fi
+	wait $pid
+}
+
+# startup sample [VAR=value ...] program: starts it STARTUP_RUNS times, each
+# run ending at its first frame, and lists the times to first frame
+startup() {
+	name=$1
+	shift
+	[ -f "$RESULTS/$name.skip" ] && return
+	echo "$name: $STARTUP_RUNS startup runs"
+
+	i=0
+	times=
+	while [ $i -lt "$STARTUP_RUNS" ]; do
+		rm -f "$RESULTS/$name.startup.json"
+		timeout 30 env WIDTH="$WIDTH" HEIGHT="$HEIGHT" EXIT_AFTER_FIRST_FRAME=1 \
+			FRAME_PROBE_OUTPUT="$RESULTS/$name.startup.json" LD_PRELOAD="$BUILD/frame-probe.so" \
+			"$@" > /dev/null 2>&1
+		ms=$(sed -n 's/.*"startup_ms": \([0-9.]*\).*/\1/p' "$RESULTS/$name.startup.json" 2>/dev/null)
+		times="$times${times:+, }${ms:-null}"
+		i=$((i + 1))
+	done
+	echo "$times" > "$RESULTS/$name.startup"
+}
+
+# dispatch action sample: calls action with the sample's command line
+dispatch() {
+	case $2 in
+		essos-sample|essos-egl) $1 $2 "$BUILD/essos-test/$2" ;;
+		qt-egl-test|qt-quick-test) $1 $2 FRAMES=0 "$BUILD/$2/$2" ;;
+		sdl-test) $1 $2 "$BUILD/cmake/$2/$2" ;;
+		sdl-game-test) $1 $2 RESOURCE_DIR="$SRC/sdl-game-test/resources" "$BUILD/cmake/$2/$2" ;;
+		wayland-egl) $1 $2 "$BUILD/$2" ;;
+		*) skip "$2" "unknown sample" ;;
+	esac
+}
+
+# status sample reason: a JSON object for a sample without a probe report
+status() {
+	printf '{"status": "%s", "reason": "%s"}' "$1" "$(sed 's/["\\]/\\&/g' "$2")"
+}
+
+if ! build_probe; then
+	echo "$0: failed to build frame-probe.so"
+	exit 1
+fi
+
+if wanted essos-sample || wanted essos-egl; then build_essos; fi
+if wanted wayland-egl; then build_wayland_egl; fi
+if wanted qt-egl-test; then build_qt qt-egl-test; fi
+if wanted qt-quick-test; then build_qt qt-quick-test; fi
+if wanted sdl-test || wanted sdl-game-test; then build_sdl; fi
+
+if [ $HEADLESS -eq 1 ]; then
+	export BACKEND=pbuffer EGL_PLATFORM=surfaceless QT_QPA_PLATFORM=offscreen SDL_VIDEODRIVER=offscreen
+	if wanted essos-sample && [ ! -f "$RESULTS/essos-sample.skip" ]; then
+		skip essos-sample "no headless backend"
+	fi
+fi
+
+for sample in $SAMPLES; do
+	dispatch run $sample
+	if [ "$STARTUP_RUNS" -gt 0 ] && [ ! -f "$RESULTS/$sample.skip" ]; then
+		dispatch startup $sample
+	fi
+done
+
+{
+	printf '{"duration_s": %s, "width": %s, "height": %s, "headless": %s, "samples": {' \
+		"$DURATION" "$WIDTH" "$HEIGHT" "$([ $HEADLESS -eq 1 ] && echo true || echo false)"
+	separator=
+	for sample in $SAMPLES; do
+		printf '%s\n  "%s": ' "$separator" "$sample"
+		separator=,
+		if [ -f "$RESULTS/$sample.skip" ]; then
+			status skipped "$RESULTS/$sample.skip"
+		elif [ -f "$RESULTS/$sample.error" ]; then
+			status error "$RESULTS/$sample.error"
+		elif [ -s "$RESULTS/$sample.json" ]; then
+			runs=
+			[ -f "$RESULTS/$sample.startup" ] && runs="\"startup_runs_ms\": [$(cat "$RESULTS/$sample.startup")], "
+			sed "s/^{/{\"status\": \"ok\", $runs/" "$RESULTS/$sample.json" | tr -d '\n'
+		else
+			echo "no frame was presented, see $RESULTS/$sample.log" > "$RESULTS/$sample.error"
+			status error "$RESULTS/$sample.error"
+		fi
+	done
+	printf '\n}}\n'
+} > "$REPORT"
+
+echo "report written to $REPORT"
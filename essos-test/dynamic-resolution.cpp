@@ -0,0 +1,370 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "dynamic-resolution.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef HAVE_EPOXY
+#  include <epoxy/egl.h>
+#else
+#  include <EGL/egl.h>
+#  include <GLES2/gl2ext.h>
+#endif
+
+// scale changes are proportional to the miss, limited per frame
+#define DYNRES_MAX_STEP_DOWN (0.85f)
+#define DYNRES_MAX_STEP_UP (1.05f)
+// frames within budget before probing a higher scale without a GPU timer
+#define DYNRES_PROBE_FRAMES (60)
+#define DYNRES_REPORT_US (5000000LL)
+
+static PFNGLGENQUERIESEXTPROC genQueries;
+static PFNGLDELETEQUERIESEXTPROC deleteQueries;
+static PFNGLBEGINQUERYEXTPROC beginQuery;
+static PFNGLENDQUERYEXTPROC endQuery;
+static PFNGLGETQUERYOBJECTUIVEXTPROC getQueryObjectuiv;
+static PFNGLGETQUERYOBJECTUI64VEXTPROC getQueryObjectui64v;
+
+static const char *vertSource=
+  "attribute vec2 pos;\n"
+  "uniform vec2 uvScale;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_Position= vec4(pos, 0.0, 1.0);\n"
+  "  uv= (pos*0.5+0.5)*uvScale;\n"
+  "}\n";
+
+static const char *fragSource=
+  "precision mediump float;\n"
+  "uniform sampler2D tex;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_FragColor= texture2D(tex, uv);\n"
+  "}\n";
+
+// one triangle covering the whole screen, clipped to it
+static const GLfloat fullScreen[3][2]=
+{
+   { -1.0f, -1.0f },
+   {  3.0f, -1.0f },
+   { -1.0f,  3.0f }
+};
+
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
+}
+
+static GLuint createShader( GLenum type, const char *source )
+{
+   GLuint shader= glCreateShader( type );
+   GLint status;
+
+   glShaderSource( shader, 1, &source, NULL );
+   glCompileShader( shader );
+   glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+   if ( !status )
+   {
+      char log[1000];
+      GLsizei len;
+      glGetShaderInfoLog( shader, 1000, &len, log );
+      printf("dynamicResolution: compiling %s shader:\n%.*s\n",
+             (type == GL_VERTEX_SHADER) ? "vertex" : "fragment", len, log );
+      glDeleteShader( shader );
+      shader= 0;
+   }
+   return shader;
+}
+
+static bool setupTimer( DynamicResolution *dr )
+{
+   const char *extensions= (const char*)glGetString( GL_EXTENSIONS );
+
+   if ( !extensions || !strstr( extensions, "GL_EXT_disjoint_timer_query" ) )
+   {
+      return false;
+   }
+
+   genQueries= (PFNGLGENQUERIESEXTPROC)eglGetProcAddress( "glGenQueriesEXT" );
+   deleteQueries= (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress( "glDeleteQueriesEXT" );
+   beginQuery= (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress( "glBeginQueryEXT" );
+   endQuery= (PFNGLENDQUERYEXTPROC)eglGetProcAddress( "glEndQueryEXT" );
+   getQueryObjectuiv= (PFNGLGETQUERYOBJECTUIVEXTPROC)eglGetProcAddress( "glGetQueryObjectuivEXT" );
+   getQueryObjectui64v= (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress( "glGetQueryObjectui64vEXT" );
+   if ( !genQueries || !deleteQueries || !beginQuery || !endQuery || !getQueryObjectuiv || !getQueryObjectui64v )
+   {
+      return false;
+   }
+
+   genQueries( DYNRES_QUERIES, dr->queries );
+
+   return true;
+}
+
+static void resize( DynamicResolution *dr, int width, int height )
+{
+   dr->displayWidth= width;
+   dr->displayHeight= height;
+
+   glBindTexture( GL_TEXTURE_2D, dr->texture );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+   glBindFramebuffer( GL_FRAMEBUFFER, dr->fbo );
+   glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dr->texture, 0 );
+   if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+   {
+      printf("dynamicResolution: framebuffer %dx%d incomplete\n", width, height);
+   }
+   printf("dynamic resolution: display %dx%d, scale %.2f - 1.00, target %.2f ms\n",
+          width, height, dr->minScale, dr->targetMs );
+}
+
+// Newest finished GPU time in ms, or -1 if none finished since last time.
+static double collectGpuTime( DynamicResolution *dr )
+{
+   double ms= -1.0;
+   GLint disjoint= 0;
+
+   while ( dr->queryCount )
+   {
+      unsigned index= (dr->queryHead+DYNRES_QUERIES-dr->queryCount) % DYNRES_QUERIES;
+      GLuint available= 0;
+      GLuint64 elapsed= 0;
+
+      getQueryObjectuiv( dr->queries[index], GL_QUERY_RESULT_AVAILABLE_EXT, &available );
+      if ( !available ) break;
+      getQueryObjectui64v( dr->queries[index], GL_QUERY_RESULT_EXT, &elapsed );
+      --dr->queryCount;
+      ms= elapsed/1000000.0;
+   }
+
+   // results spanning a GPU frequency change or similar are meaningless
+   glGetIntegerv( GL_GPU_DISJOINT_EXT, &disjoint );
+   if ( disjoint ) ms= -1.0;
+
+   return ms;
+}
+
+static void chooseScale( DynamicResolution *dr, double ms )
+{
+   float step;
+
+   // pixel count goes with the square of the scale
+   step= sqrtf( (float)(dr->targetMs/ms) );
+
+   if ( ms > dr->targetMs*1.05 )
+   {
+      dr->stableFrames= 0;
+      dr->scale *= (step < DYNRES_MAX_STEP_DOWN) ? DYNRES_MAX_STEP_DOWN : step;
+   }
+   else if ( dr->gpuTimer )
+   {
+      if ( ms < dr->targetMs*0.85 )
+      {
+         dr->scale *= (step > DYNRES_MAX_STEP_UP) ? DYNRES_MAX_STEP_UP : step;
+      }
+   }
+   else if ( ++dr->stableFrames >= DYNRES_PROBE_FRAMES )
+   {
+      // the swap waits for the refresh, so the measured time does not drop
+      // with the load and shows no headroom; try a little more and back off
+      // if it misses
+      dr->stableFrames= 0;
+      dr->scale *= 1.02f;
+   }
+
+   if ( dr->scale < dr->minScale ) dr->scale= dr->minScale;
+   if ( dr->scale > 1.0f ) dr->scale= 1.0f;
+}
+
+bool dynamicResolutionInit( DynamicResolution *dr, int targetFps, float minScale )
+{
+   GLuint vert, frag;
+   GLint status;
+
+   memset( dr, 0, sizeof(DynamicResolution) );
+   dr->targetMs= 1000.0/targetFps;
+   dr->minScale= ((minScale > 0.0f) && (minScale <= 1.0f)) ? minScale : 0.5f;
+   dr->scale= 1.0f;
+
+   vert= createShader( GL_VERTEX_SHADER, vertSource );
+   frag= createShader( GL_FRAGMENT_SHADER, fragSource );
+   if ( !vert || !frag )
+   {
+      if ( vert ) glDeleteShader( vert );
+      if ( frag ) glDeleteShader( frag );
+      return false;
+   }
+
+   dr->prog= glCreateProgram();
+   glAttachShader( dr->prog, vert );
+   glAttachShader( dr->prog, frag );
+   glBindAttribLocation( dr->prog, 0, "pos" );
+   glLinkProgram( dr->prog );
+   glDeleteShader( vert );
+   glDeleteShader( frag );
+   glGetProgramiv( dr->prog, GL_LINK_STATUS, &status );
+   if ( !status )
+   {
+      printf("dynamicResolution: program link failed\n");
+      glDeleteProgram( dr->prog );
+      dr->prog= 0;
+      return false;
+   }
+   dr->uvScale= glGetUniformLocation( dr->prog, "uvScale" );
+   glUseProgram( dr->prog );
+   glUniform1i( glGetUniformLocation( dr->prog, "tex" ), 0 );
+
+   glGenBuffers( 1, &dr->vbo );
+   glBindBuffer( GL_ARRAY_BUFFER, dr->vbo );
+   glBufferData( GL_ARRAY_BUFFER, sizeof(fullScreen), fullScreen, GL_STATIC_DRAW );
+   glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+   glGenTextures( 1, &dr->texture );
+   glBindTexture( GL_TEXTURE_2D, dr->texture );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+   glGenFramebuffers( 1, &dr->fbo );
+
+   dr->gpuTimer= setupTimer( dr );
+   printf("dynamic resolution: timing from %s\n", dr->gpuTimer ? "GPU timer queries" : "render start to swap");
+
+   return true;
+}
+
+void dynamicResolutionTerm( DynamicResolution *dr )
+{
+   if ( dr->gpuTimer ) deleteQueries( DYNRES_QUERIES, dr->queries );
+   if ( dr->fbo ) glDeleteFramebuffers( 1, &dr->fbo );
+   if ( dr->texture ) glDeleteTextures( 1, &dr->texture );
+   if ( dr->vbo ) glDeleteBuffers( 1, &dr->vbo );
+   if ( dr->prog ) glDeleteProgram( dr->prog );
+   dr->fbo= dr->texture= dr->vbo= dr->prog= 0;
+}
+
+void dynamicResolutionBegin( DynamicResolution *dr, int displayWidth, int displayHeight )
+{
+   if ( (displayWidth != dr->displayWidth) || (displayHeight != dr->displayHeight) )
+   {
+      resize( dr, displayWidth, displayHeight );
+   }
+
+   dr->renderWidth= (int)(displayWidth*dr->scale+0.5f);
+   dr->renderHeight= (int)(displayHeight*dr->scale+0.5f);
+   if ( dr->renderWidth < 1 ) dr->renderWidth= 1;
+   if ( dr->renderHeight < 1 ) dr->renderHeight= 1;
+
+   // a query still in flight after DYNRES_QUERIES frames is skipped this frame
+   if ( dr->gpuTimer && (dr->queryCount < DYNRES_QUERIES) )
+   {
+      beginQuery( GL_TIME_ELAPSED_EXT, dr->queries[dr->queryHead] );
+   }
+
+   glBindFramebuffer( GL_FRAMEBUFFER, dr->fbo );
+   glViewport( 0, 0, dr->renderWidth, dr->renderHeight );
+   dr->beginUs= currentTimeMicros();
+}
+
+void dynamicResolutionEnd( DynamicResolution *dr )
+{
+   glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+   glViewport( 0, 0, dr->displayWidth, dr->displayHeight );
+   glUseProgram( dr->prog );
+   glUniform2f( dr->uvScale,
+                (float)dr->renderWidth/dr->displayWidth,
+                (float)dr->renderHeight/dr->displayHeight );
+   glActiveTexture( GL_TEXTURE0 );
+   glBindTexture( GL_TEXTURE_2D, dr->texture );
+   glBindBuffer( GL_ARRAY_BUFFER, dr->vbo );
+   glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+   glEnableVertexAttribArray( 0 );
+   glDrawArrays( GL_TRIANGLES, 0, 3 );
+
+   if ( dr->gpuTimer && (dr->queryCount < DYNRES_QUERIES) )
+   {
+      endQuery( GL_TIME_ELAPSED_EXT );
+      dr->queryHead= (dr->queryHead+1) % DYNRES_QUERIES;
+      ++dr->queryCount;
+   }
+}
+
+void dynamicResolutionPresented( DynamicResolution *dr )
+{
+   long long now= currentTimeMicros();
+   double ms= -1.0;
+   int bin;
+
+   if ( dr->gpuTimer )
+   {
+      ms= collectGpuTime( dr );
+   }
+   else if ( dr->beginUs )
+   {
+      // time spent idle before the frame began is not its cost
+      ms= (now-dr->beginUs)/1000.0;
+   }
+   dr->beginUs= 0;
+
+   ++dr->frames;
+   dr->scaleSum += dr->scale;
+   bin= (int)(dr->scale*DYNRES_SCALE_BINS);
+   if ( bin >= DYNRES_SCALE_BINS ) bin= DYNRES_SCALE_BINS-1;
+   ++dr->scaleBins[bin];
+
+   if ( ms >= 0.0 )
+   {
+      dr->frameMs= ms;
+      chooseScale( dr, ms );
+   }
+
+   if ( now-dr->lastReportUs >= DYNRES_REPORT_US )
+   {
+      if ( dr->lastReportUs )
+      {
+         printf("dynamic resolution: scale %.2f (%dx%d) %s %.2f ms\n",
+                dr->scale, dr->renderWidth, dr->renderHeight,
+                dr->gpuTimer ? "gpu" : "frame", dr->frameMs );
+      }
+      dr->lastReportUs= now;
+   }
+}
+
+void dynamicResolutionShowStats( DynamicResolution *dr )
+{
+   if ( !dr->frames ) return;
+
+   printf("dynamic resolution: %lu frames, mean scale %.2f, last %.2f\n",
+          dr->frames, dr->scaleSum/dr->frames, dr->scale );
+   for( int i= 0; i < DYNRES_SCALE_BINS; ++i )
+   {
+      if ( dr->scaleBins[i] )
+      {
+         printf("  %.2f - %.2f: %lu\n",
+                (float)i/DYNRES_SCALE_BINS, (float)(i+1)/DYNRES_SCALE_BINS, dr->scaleBins[i] );
+      }
+   }
+}
@@ -0,0 +1,90 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _DYNAMIC_RESOLUTION_H
+#define _DYNAMIC_RESOLUTION_H
+
+#ifdef HAVE_EPOXY
+#  include <epoxy/gl.h>
+#else
+#  include <GLES2/gl2.h>
+#endif
+
+/*
+ * Dynamic resolution: the scene is drawn into an offscreen framebuffer at a
+ * fraction of the display size and stretched to the display afterwards. The
+ * fraction follows the measured frame time so that the target rate is kept.
+ *
+ * The framebuffer is allocated at full display size once, lower scales only
+ * use a smaller viewport of it, so scale changes cost nothing.
+ */
+
+#define DYNRES_QUERIES (4)
+#define DYNRES_SCALE_BINS (20)
+
+typedef struct _DynamicResolution
+{
+   double targetMs;
+   float minScale;
+   float scale;
+   int displayWidth;
+   int displayHeight;
+   int renderWidth;
+   int renderHeight;
+   GLuint fbo;
+   GLuint texture;
+   GLuint prog;
+   GLuint vbo;
+   GLint uvScale;
+   // GPU time from EXT_disjoint_timer_query when available, otherwise the
+   // time from dynamicResolutionBegin to the end of the swap, so that idle
+   // time between on-demand or rate-capped frames is not counted
+   bool gpuTimer;
+   GLuint queries[DYNRES_QUERIES];
+   unsigned queryHead;
+   unsigned queryCount;
+   long long beginUs;
+   double frameMs;
+   int stableFrames;
+   // scale statistics
+   unsigned long frames;
+   double scaleSum;
+   unsigned long scaleBins[DYNRES_SCALE_BINS];
+   long long lastReportUs;
+} DynamicResolution;
+
+// Needs a current context. targetFps > 0, minScale in (0,1].
+bool dynamicResolutionInit( DynamicResolution *dr, int targetFps, float minScale );
+void dynamicResolutionTerm( DynamicResolution *dr );
+
+// Binds the offscreen framebuffer and sets the viewport to the scaled size,
+// which is left in renderWidth/renderHeight for the caller.
+void dynamicResolutionBegin( DynamicResolution *dr, int displayWidth, int displayHeight );
+
+// Stretches the scaled image to the default framebuffer. Changes the current
+// program, GL_ARRAY_BUFFER binding and vertex attribute 0; the caller
+// restores its own.
+void dynamicResolutionEnd( DynamicResolution *dr );
+
+// Called once the frame has been swapped: measures it and picks the scale
+// for the next frame.
+void dynamicResolutionPresented( DynamicResolution *dr );
+
+void dynamicResolutionShowStats( DynamicResolution *dr );
+
+#endif
@@ -0,0 +1,293 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "egl-backend.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_EPOXY
+#  include <epoxy/gl.h>
+#else
+#  include <EGL/eglext.h>
+#  include <GLES2/gl2.h>
+#endif
+#ifdef HAVE_GBM
+#  include <gbm.h>
+#endif
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_PLATFORM_GBM_KHR
+#define EGL_PLATFORM_GBM_KHR 0x31D7
+#endif
+
+#define DEFAULT_RENDER_NODE "/dev/dri/renderD128"
+
+EglBackendType eglBackendFromName( const char *name )
+{
+   if ( name )
+   {
+      if ( !strcmp( name, "surfaceless" ) ) return EglBackend_surfaceless;
+      if ( !strcmp( name, "pbuffer" ) ) return EglBackend_pbuffer;
+      if ( !strcmp( name, "gbm" ) ) return EglBackend_gbm;
+      if ( strcmp( name, "display" ) )
+      {
+         printf("eglBackend: unknown backend %s, using display (display, surfaceless, pbuffer or gbm)\n", name);
+      }
+   }
+   return EglBackend_display;
+}
+
+const char* eglBackendName( EglBackendType type )
+{
+   switch( type )
+   {
+      case EglBackend_surfaceless: return "surfaceless";
+      case EglBackend_pbuffer: return "pbuffer";
+      case EglBackend_gbm: return "gbm";
+      default: return "display";
+   }
+}
+
+static EGLDisplay getPlatformDisplay( EGLenum platform, void *native )
+{
+   const char *extensions= eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+   PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplayEXT;
+
+   if ( !extensions || !strstr( extensions, "EGL_EXT_platform_base" ) )
+   {
+      printf("eglBackend: EGL_EXT_platform_base not supported\n");
+      return EGL_NO_DISPLAY;
+   }
+   getPlatformDisplayEXT= (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+   if ( !getPlatformDisplayEXT )
+   {
+      return EGL_NO_DISPLAY;
+   }
+   return getPlatformDisplayEXT( platform, native, NULL );
+}
+
+static bool createGbm( EglBackend *backend )
+{
+#ifdef HAVE_GBM
+   const char *node= getenv("GBM_DEVICE");
+
+   if ( !node ) node= DEFAULT_RENDER_NODE;
+   backend->drmFd= open( node, O_RDWR|O_CLOEXEC );
+   if ( backend->drmFd < 0 )
+   {
+      printf("eglBackend: unable to open %s\n", node);
+      return false;
+   }
+   backend->gbmDevice= gbm_create_device( backend->drmFd );
+   if ( !backend->gbmDevice )
+   {
+      printf("eglBackend: gbm_create_device failed for %s\n", node);
+      return false;
+   }
+   backend->display= getPlatformDisplay( EGL_PLATFORM_GBM_KHR, backend->gbmDevice );
+   return true;
+#else
+   (void)backend;
+   printf("eglBackend: built without GBM support\n");
+   return false;
+#endif
+}
+
+// GBM surfaces need the config whose visual matches the buffer format.
+static bool chooseConfig( EglBackend *backend )
+{
+   EGLint surfaceType= (backend->type == EglBackend_gbm) ? EGL_WINDOW_BIT : EGL_PBUFFER_BIT;
+   EGLint attributes[]=
+   {
+      EGL_SURFACE_TYPE, surfaceType,
+      EGL_RED_SIZE, 8,
+      EGL_GREEN_SIZE, 8,
+      EGL_BLUE_SIZE, 8,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+      EGL_NONE
+   };
+   EGLConfig configs[64];
+   EGLint count= 0;
+
+   if ( !eglChooseConfig( backend->display, attributes, configs, 64, &count ) || (count == 0) )
+   {
+      return false;
+   }
+
+   backend->config= configs[0];
+#ifdef HAVE_GBM
+   if ( backend->type == EglBackend_gbm )
+   {
+      for( int i= 0; i < count; ++i )
+      {
+         EGLint visual= 0;
+
+         eglGetConfigAttrib( backend->display, configs[i], EGL_NATIVE_VISUAL_ID, &visual );
+         if ( visual == GBM_FORMAT_XRGB8888 )
+         {
+            backend->config= configs[i];
+            break;
+         }
+      }
+   }
+#endif
+   return true;
+}
+
+bool eglBackendCreate( EglBackend *backend, EglBackendType type, int width, int height )
+{
+   EGLint contextAttributes[]= { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+   EGLint bufferSize= 32;
+
+   memset( backend, 0, sizeof(EglBackend) );
+   backend->type= type;
+   backend->width= width;
+   backend->height= height;
+   backend->drmFd= -1;
+   backend->display= EGL_NO_DISPLAY;
+   backend->surface= EGL_NO_SURFACE;
+   backend->context= EGL_NO_CONTEXT;
+
+   switch( type )
+   {
+      case EglBackend_surfaceless:
+         backend->display= getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY );
+         break;
+      case EglBackend_pbuffer:
+         backend->display= eglGetDisplay( EGL_DEFAULT_DISPLAY );
+         break;
+      case EglBackend_gbm:
+         if ( !createGbm( backend ) ) goto error;
+         break;
+      default:
+         printf("eglBackend: %s is not a headless backend\n", eglBackendName( type ));
+         goto error;
+   }
+
+   if ( (backend->display == EGL_NO_DISPLAY) || !eglInitialize( backend->display, NULL, NULL ) )
+   {
+      printf("eglBackend: no %s display\n", eglBackendName( type ));
+      goto error;
+   }
+
+   eglBindAPI( EGL_OPENGL_ES_API );
+   if ( !chooseConfig( backend ) )
+   {
+      printf("eglBackend: no suitable config\n");
+      goto error;
+   }
+
+   if ( type == EglBackend_gbm )
+   {
+#ifdef HAVE_GBM
+      backend->gbmSurface= gbm_surface_create( (struct gbm_device*)backend->gbmDevice, width, height,
+                                               GBM_FORMAT_XRGB8888, GBM_BO_USE_RENDERING );
+      if ( !backend->gbmSurface )
+      {
+         printf("eglBackend: gbm_surface_create failed\n");
+         goto error;
+      }
+      backend->surface= eglCreateWindowSurface( backend->display, backend->config,
+                                                (EGLNativeWindowType)backend->gbmSurface, NULL );
+#endif
+   }
+   else
+   {
+      EGLint pbufferAttributes[]= { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+
+      backend->surface= eglCreatePbufferSurface( backend->display, backend->config, pbufferAttributes );
+   }
+   if ( backend->surface == EGL_NO_SURFACE )
+   {
+      printf("eglBackend: unable to create %dx%d surface: 0x%X\n", width, height, eglGetError());
+      goto error;
+   }
+
+   backend->context= eglCreateContext( backend->display, backend->config, EGL_NO_CONTEXT, contextAttributes );
+   if ( (backend->context == EGL_NO_CONTEXT) ||
+        !eglMakeCurrent( backend->display, backend->surface, backend->surface, backend->context ) )
+   {
+      printf("eglBackend: unable to create context: 0x%X\n", eglGetError());
+      goto error;
+   }
+
+   eglGetConfigAttrib( backend->display, backend->config, EGL_BUFFER_SIZE, &bufferSize );
+   backend->bytesPerPixel= (bufferSize+7)/8;
+
+   printf("eglBackend: %s %dx%d, %d bytes per pixel, renderer %s\n",
+          eglBackendName( type ), width, height, backend->bytesPerPixel,
+          (const char*)glGetString( GL_RENDERER ));
+
+   return true;
+
+error:
+   eglBackendDestroy( backend );
+   return false;
+}
+
+void eglBackendDestroy( EglBackend *backend )
+{
+   if ( backend->display != EGL_NO_DISPLAY )
+   {
+      eglMakeCurrent( backend->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+      if ( backend->context != EGL_NO_CONTEXT ) eglDestroyContext( backend->display, backend->context );
+      if ( backend->surface != EGL_NO_SURFACE ) eglDestroySurface( backend->display, backend->surface );
+      eglTerminate( backend->display );
+   }
+#ifdef HAVE_GBM
+   if ( backend->gbmFrontBuffer )
+   {
+      gbm_surface_release_buffer( (struct gbm_surface*)backend->gbmSurface, (struct gbm_bo*)backend->gbmFrontBuffer );
+   }
+   if ( backend->gbmSurface ) gbm_surface_destroy( (struct gbm_surface*)backend->gbmSurface );
+   if ( backend->gbmDevice ) gbm_device_destroy( (struct gbm_device*)backend->gbmDevice );
+#endif
+   if ( backend->drmFd >= 0 ) close( backend->drmFd );
+   backend->display= EGL_NO_DISPLAY;
+   backend->context= EGL_NO_CONTEXT;
+   backend->surface= EGL_NO_SURFACE;
+   backend->gbmFrontBuffer= backend->gbmSurface= backend->gbmDevice= 0;
+   backend->drmFd= -1;
+}
+
+void eglBackendSwap( EglBackend *backend )
+{
+   eglSwapBuffers( backend->display, backend->surface );
+#ifdef HAVE_GBM
+   if ( backend->type == EglBackend_gbm )
+   {
+      // nothing scans out, hand the previous buffer straight back
+      struct gbm_bo *bo= gbm_surface_lock_front_buffer( (struct gbm_surface*)backend->gbmSurface );
+
+      if ( backend->gbmFrontBuffer )
+      {
+         gbm_surface_release_buffer( (struct gbm_surface*)backend->gbmSurface, (struct gbm_bo*)backend->gbmFrontBuffer );
+      }
+      backend->gbmFrontBuffer= bo;
+   }
+#endif
+   // a pbuffer swap does not wait for anything, without this the loop
+   // would only measure how fast commands can be queued
+   glFinish();
+}
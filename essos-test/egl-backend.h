@@ -0,0 +1,75 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _EGL_BACKEND_H
+#define _EGL_BACKEND_H
+
+#ifdef HAVE_EPOXY
+#  include <epoxy/egl.h>
+#else
+#  include <EGL/egl.h>
+#endif
+
+/*
+ * Headless EGL targets, so the render loops can run without a display
+ * server, e.g. on build machines with Mesa software rendering:
+ *
+ *  surfaceless  EGL_MESA_platform_surfaceless display, pbuffer surface
+ *  pbuffer      default display, pbuffer surface
+ *  gbm          GBM device on a DRM render node, GBM window surface
+ *               (only with HAVE_GBM)
+ */
+
+typedef enum _EglBackendType
+{
+   EglBackend_display,
+   EglBackend_surfaceless,
+   EglBackend_pbuffer,
+   EglBackend_gbm
+} EglBackendType;
+
+typedef struct _EglBackend
+{
+   EglBackendType type;
+   EGLDisplay display;
+   EGLConfig config;
+   EGLContext context;
+   EGLSurface surface;
+   int width;
+   int height;
+   int bytesPerPixel;
+   int drmFd;
+   void *gbmDevice;
+   void *gbmSurface;
+   void *gbmFrontBuffer;
+} EglBackend;
+
+// Maps a BACKEND value to a type; anything unknown is the display backend
+// and is reported.
+EglBackendType eglBackendFromName( const char *name );
+const char* eglBackendName( EglBackendType type );
+
+// Creates display, context and surface and makes them current.
+bool eglBackendCreate( EglBackend *backend, EglBackendType type, int width, int height );
+void eglBackendDestroy( EglBackend *backend );
+
+// Swaps and waits for the GPU, so that a frame is only counted once it has
+// actually been rendered.
+void eglBackendSwap( EglBackend *backend );
+
+#endif
@@ -0,0 +1,772 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Video overlay style rendering of CPU produced frames, two ways:
+ *
+ *  dmabuf  frames are written into dmabufs (udmabuf or GBM allocated) that
+ *          were imported once with EGL_EXT_image_dma_buf_import and are
+ *          sampled as GL_TEXTURE_EXTERNAL_OES, no copy after the write
+ *  upload  frames are written into ordinary memory and copied into a
+ *          texture with glTexSubImage2D every frame
+ *
+ * Each path runs for FRAMES frames (MODE=dmabuf|upload|both) and reports
+ * the time to write a frame, the time to hand it to GL with the resulting
+ * bandwidth, and the frame time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/dma-buf.h>
+#ifdef HAVE_UDMABUF
+#include <linux/udmabuf.h>
+#endif
+#ifdef HAVE_GBM
+#include <gbm.h>
+#endif
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "essos-app.h"
+#include "egl-backend.h"
+
+#ifndef DRM_FORMAT_XRGB8888
+#define DRM_FORMAT_XRGB8888 (0x34325258) // XR24
+#endif
+
+// frames in flight: the one being written, the one queued, the one shown
+#define BUFFER_COUNT (3)
+
+typedef enum _Producer
+{
+   Producer_udmabuf,
+   Producer_gbm
+} Producer;
+
+typedef struct _FrameBuffer
+{
+   int dmabufFd;
+   int memFd;
+   void *map;
+   size_t size;
+   int stride;
+   void *bo;
+   EGLImageKHR image;
+   GLuint texture;
+} FrameBuffer;
+
+typedef struct _PathStats
+{
+   const char *name;
+   unsigned long frames;
+   double fillMs;
+   double uploadMs;
+   double frameMs;
+   double frameMaxMs;
+   unsigned long long bytes;
+   long long prevUs;
+} PathStats;
+
+static EssCtx *ctx= 0;
+static bool gRunning= false;
+static EglBackendType gBackend= EglBackend_display;
+static EglBackend gEglBackend;
+static Producer gProducer= Producer_udmabuf;
+static int gWidth= 1920;
+static int gHeight= 1080;
+static int gDisplayWidth;
+static int gDisplayHeight;
+static unsigned long gFramesPerPath= 300;
+static bool gRunDmabuf= true;
+static bool gRunUpload= true;
+
+static FrameBuffer gBuffers[BUFFER_COUNT];
+#ifdef HAVE_GBM
+static int gDrmFd= -1;
+static struct gbm_device *gGbmDevice= 0;
+#endif
+static unsigned char *gStaging= 0;
+static GLuint gUploadTextures[BUFFER_COUNT];
+static GLenum gUploadFormat= GL_RGBA;
+static unsigned int *gPatternRow= 0;
+static GLuint gExternalProg= 0;
+static GLuint g2DProg= 0;
+static GLuint gVbo= 0;
+static PathStats gStats[2];
+
+static PFNEGLCREATEIMAGEKHRPROC createImage;
+static PFNEGLDESTROYIMAGEKHRPROC destroyImage;
+static PFNGLEGLIMAGETARGETTEXTURE2DOESPROC imageTargetTexture2D;
+
+static const char *vertSource=
+  "attribute vec2 pos;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_Position= vec4(pos, 0.0, 1.0);\n"
+  "  uv= vec2(pos.x*0.5+0.5, 0.5-pos.y*0.5);\n"
+  "}\n";
+
+static const char *externalSource=
+  "#extension GL_OES_EGL_image_external : require\n"
+  "precision mediump float;\n"
+  "uniform samplerExternalOES tex;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_FragColor= texture2D(tex, uv);\n"
+  "}\n";
+
+static const char *textureSource=
+  "precision mediump float;\n"
+  "uniform sampler2D tex;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_FragColor= texture2D(tex, uv);\n"
+  "}\n";
+
+static const GLfloat quad[4][2]=
+{
+   { -1.0f, -1.0f },
+   {  1.0f, -1.0f },
+   { -1.0f,  1.0f },
+   {  1.0f,  1.0f }
+};
+
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
+}
+
+static void loadEnv(void)
+{
+   const char *env;
+
+   env= getenv("WIDTH");
+   if ( env ) gWidth= atoi(env);
+   env= getenv("HEIGHT");
+   if ( env ) gHeight= atoi(env);
+
+   env= getenv("FRAMES");
+   if ( env )
+   {
+      gFramesPerPath= strtoul(env, NULL, 10);
+      if ( gFramesPerPath < 2 ) gFramesPerPath= 2;
+   }
+
+   // PRODUCER=udmabuf|gbm allocates the buffers for the dmabuf path
+   env= getenv("PRODUCER");
+   if ( env && !strcmp( env, "gbm" ) )
+   {
+      gProducer= Producer_gbm;
+   }
+
+   // MODE=dmabuf|upload|both
+   env= getenv("MODE");
+   if ( env )
+   {
+      gRunDmabuf= !strcmp( env, "dmabuf" ) || !strcmp( env, "both" );
+      gRunUpload= !strcmp( env, "upload" ) || !strcmp( env, "both" );
+   }
+
+   gBackend= eglBackendFromName( getenv("BACKEND") );
+}
+
+static GLuint createProgram( const char *fragSource )
+{
+   const char *sources[2]= { vertSource, fragSource };
+   GLenum types[2]= { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+   GLuint prog= glCreateProgram();
+   GLint status;
+
+   for( int i= 0; i < 2; ++i )
+   {
+      GLuint shader= glCreateShader( types[i] );
+
+      glShaderSource( shader, 1, &sources[i], NULL );
+      glCompileShader( shader );
+      glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+      if ( !status )
+      {
+         char log[1000];
+         GLsizei len;
+         glGetShaderInfoLog( shader, sizeof(log), &len, log );
+         printf("Error compiling %s shader: %.*s\n",
+                (types[i] == GL_VERTEX_SHADER) ? "vertex" : "fragment", len, log );
+      }
+      glAttachShader( prog, shader );
+      glDeleteShader( shader );
+   }
+   glBindAttribLocation( prog, 0, "pos" );
+   glLinkProgram( prog );
+   glGetProgramiv( prog, GL_LINK_STATUS, &status );
+   if ( !status )
+   {
+      glDeleteProgram( prog );
+      return 0;
+   }
+   glUseProgram( prog );
+   glUniform1i( glGetUniformLocation( prog, "tex" ), 0 );
+
+   return prog;
+}
+
+static bool hasExtension( const char *extensions, const char *name )
+{
+   return extensions && strstr( extensions, name );
+}
+
+// Backs a udmabuf with a sealed memfd; the CPU writes through the memfd
+// mapping, the GPU reads the same pages.
+static bool allocUdmabuf( FrameBuffer *buffer )
+{
+#ifdef HAVE_UDMABUF
+   struct udmabuf_create create;
+   long page= sysconf( _SC_PAGESIZE );
+   int dev;
+
+   buffer->stride= gWidth*4;
+   buffer->size= ((size_t)buffer->stride*gHeight+page-1) & ~(size_t)(page-1);
+
+   buffer->memFd= memfd_create( "essos-dmabuf", MFD_ALLOW_SEALING|MFD_CLOEXEC );
+   if ( (buffer->memFd < 0) ||
+        (ftruncate( buffer->memFd, buffer->size ) < 0) ||
+        (fcntl( buffer->memFd, F_ADD_SEALS, F_SEAL_SHRINK ) < 0) )
+   {
+      printf("udmabuf: memfd setup failed\n");
+      return false;
+   }
+
+   dev= open( "/dev/udmabuf", O_RDWR|O_CLOEXEC );
+   if ( dev < 0 )
+   {
+      printf("udmabuf: /dev/udmabuf not available\n");
+      return false;
+   }
+   memset( &create, 0, sizeof(create) );
+   create.memfd= buffer->memFd;
+   create.flags= UDMABUF_FLAGS_CLOEXEC;
+   create.offset= 0;
+   create.size= buffer->size;
+   buffer->dmabufFd= ioctl( dev, UDMABUF_CREATE, &create );
+   close( dev );
+   if ( buffer->dmabufFd < 0 )
+   {
+      printf("udmabuf: UDMABUF_CREATE failed\n");
+      return false;
+   }
+
+   buffer->map= mmap( NULL, buffer->size, PROT_READ|PROT_WRITE, MAP_SHARED, buffer->memFd, 0 );
+   if ( buffer->map == MAP_FAILED )
+   {
+      buffer->map= 0;
+      return false;
+   }
+   return true;
+#else
+   (void)buffer;
+   printf("udmabuf: built without udmabuf support\n");
+   return false;
+#endif
+}
+
+// Linear GBM buffer, written through a mapping of its dmabuf.
+static bool allocGbm( FrameBuffer *buffer )
+{
+#ifdef HAVE_GBM
+   struct gbm_bo *bo;
+
+   if ( !gGbmDevice )
+   {
+      const char *node= getenv("GBM_DEVICE");
+
+      gDrmFd= open( node ? node : "/dev/dri/renderD128", O_RDWR|O_CLOEXEC );
+      if ( gDrmFd >= 0 )
+      {
+         gGbmDevice= gbm_create_device( gDrmFd );
+      }
+      if ( !gGbmDevice )
+      {
+         printf("gbm: no device\n");
+         return false;
+      }
+   }
+
+   bo= gbm_bo_create( gGbmDevice, gWidth, gHeight, GBM_FORMAT_XRGB8888,
+                      GBM_BO_USE_LINEAR|GBM_BO_USE_RENDERING );
+   if ( !bo )
+   {
+      printf("gbm: gbm_bo_create failed\n");
+      return false;
+   }
+   buffer->bo= bo;
+   buffer->stride= gbm_bo_get_stride( bo );
+   buffer->size= (size_t)buffer->stride*gHeight;
+   buffer->dmabufFd= gbm_bo_get_fd( bo );
+   if ( buffer->dmabufFd < 0 )
+   {
+      return false;
+   }
+   buffer->map= mmap( NULL, buffer->size, PROT_READ|PROT_WRITE, MAP_SHARED, buffer->dmabufFd, 0 );
+   if ( buffer->map == MAP_FAILED )
+   {
+      printf("gbm: dmabuf mmap failed\n");
+      buffer->map= 0;
+      return false;
+   }
+   return true;
+#else
+   (void)buffer;
+   printf("gbm: built without GBM support\n");
+   return false;
+#endif
+}
+
+static bool importBuffer( FrameBuffer *buffer, EGLDisplay display )
+{
+   EGLint attributes[]=
+   {
+      EGL_WIDTH, gWidth,
+      EGL_HEIGHT, gHeight,
+      EGL_LINUX_DRM_FOURCC_EXT, DRM_FORMAT_XRGB8888,
+      EGL_DMA_BUF_PLANE0_FD_EXT, buffer->dmabufFd,
+      EGL_DMA_BUF_PLANE0_OFFSET_EXT, 0,
+      EGL_DMA_BUF_PLANE0_PITCH_EXT, buffer->stride,
+      EGL_NONE
+   };
+
+   buffer->image= createImage( display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, NULL, attributes );
+   if ( buffer->image == EGL_NO_IMAGE_KHR )
+   {
+      printf("dmabuf: eglCreateImageKHR failed: 0x%X\n", eglGetError());
+      return false;
+   }
+
+   glGenTextures( 1, &buffer->texture );
+   glBindTexture( GL_TEXTURE_EXTERNAL_OES, buffer->texture );
+   glTexParameteri( GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   imageTargetTexture2D( GL_TEXTURE_EXTERNAL_OES, (GLeglImageOES)buffer->image );
+
+   return (glGetError() == GL_NO_ERROR);
+}
+
+static bool setupDmabuf( EGLDisplay display )
+{
+   const char *eglExtensions= eglQueryString( display, EGL_EXTENSIONS );
+   const char *glExtensions= (const char*)glGetString( GL_EXTENSIONS );
+
+   if ( !hasExtension( eglExtensions, "EGL_EXT_image_dma_buf_import" ) ||
+        !hasExtension( glExtensions, "GL_OES_EGL_image_external" ) )
+   {
+      printf("dmabuf: EGL_EXT_image_dma_buf_import or GL_OES_EGL_image_external missing\n");
+      return false;
+   }
+   createImage= (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress( "eglCreateImageKHR" );
+   destroyImage= (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress( "eglDestroyImageKHR" );
+   imageTargetTexture2D= (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress( "glEGLImageTargetTexture2DOES" );
+   if ( !createImage || !destroyImage || !imageTargetTexture2D )
+   {
+      return false;
+   }
+
+   gExternalProg= createProgram( externalSource );
+   if ( !gExternalProg )
+   {
+      return false;
+   }
+
+   for( int i= 0; i < BUFFER_COUNT; ++i )
+   {
+      FrameBuffer *buffer= &gBuffers[i];
+      bool allocated= (gProducer == Producer_gbm) ? allocGbm( buffer ) : allocUdmabuf( buffer );
+
+      if ( !allocated || !importBuffer( buffer, display ) )
+      {
+         return false;
+      }
+   }
+   printf("dmabuf: %d %s buffers %dx%d stride %d imported\n",
+          BUFFER_COUNT, (gProducer == Producer_gbm) ? "gbm" : "udmabuf", gWidth, gHeight, gBuffers[0].stride);
+
+   return true;
+}
+
+static bool setupUpload(void)
+{
+   const char *glExtensions= (const char*)glGetString( GL_EXTENSIONS );
+
+   // XRGB8888 is B,G,R,X in memory; without BGRA uploads the colors swap,
+   // which does not matter for the timing
+   if ( hasExtension( glExtensions, "GL_EXT_texture_format_BGRA8888" ) )
+   {
+      gUploadFormat= GL_BGRA_EXT;
+   }
+
+   gStaging= (unsigned char*)malloc( (size_t)gWidth*gHeight*4 );
+   g2DProg= createProgram( textureSource );
+   if ( !gStaging || !g2DProg )
+   {
+      return false;
+   }
+
+   glGenTextures( BUFFER_COUNT, gUploadTextures );
+   for( int i= 0; i < BUFFER_COUNT; ++i )
+   {
+      glBindTexture( GL_TEXTURE_2D, gUploadTextures[i] );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glTexImage2D( GL_TEXTURE_2D, 0, gUploadFormat, gWidth, gHeight, 0, gUploadFormat, GL_UNSIGNED_BYTE, NULL );
+   }
+   printf("upload: %d textures %dx%d, %s\n", BUFFER_COUNT, gWidth, gHeight,
+          (gUploadFormat == GL_BGRA_EXT) ? "BGRA" : "RGBA");
+
+   return true;
+}
+
+static bool setupGL( EGLDisplay display )
+{
+   gPatternRow= (unsigned int*)malloc( (size_t)gWidth*2*sizeof(unsigned int) );
+   if ( !gPatternRow )
+   {
+      return false;
+   }
+   // two periods of colored bars, a frame copies a window of it per row
+   for( int x= 0; x < gWidth*2; ++x )
+   {
+      int bar= ((x % gWidth)*8)/gWidth;
+
+      gPatternRow[x]= 0xFF000000 | ((bar & 1) ? 0xFF0000 : 0) | ((bar & 2) ? 0xFF00 : 0) | ((bar & 4) ? 0xFF : 0);
+   }
+
+   glGenBuffers( 1, &gVbo );
+   glBindBuffer( GL_ARRAY_BUFFER, gVbo );
+   glBufferData( GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW );
+   glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+   glEnableVertexAttribArray( 0 );
+
+   if ( gRunDmabuf && !setupDmabuf( display ) )
+   {
+      printf("dmabuf path unavailable\n");
+      gRunDmabuf= false;
+   }
+   if ( gRunUpload && !setupUpload() )
+   {
+      printf("upload path unavailable\n");
+      gRunUpload= false;
+   }
+
+   return gRunDmabuf || gRunUpload;
+}
+
+static void termGL( EGLDisplay display )
+{
+   for( int i= 0; i < BUFFER_COUNT; ++i )
+   {
+      FrameBuffer *buffer= &gBuffers[i];
+
+      if ( buffer->texture ) glDeleteTextures( 1, &buffer->texture );
+      if ( buffer->image ) destroyImage( display, buffer->image );
+      if ( buffer->map ) munmap( buffer->map, buffer->size );
+      if ( buffer->dmabufFd > 0 ) close( buffer->dmabufFd );
+      if ( buffer->memFd > 0 ) close( buffer->memFd );
+#ifdef HAVE_GBM
+      if ( buffer->bo ) gbm_bo_destroy( (struct gbm_bo*)buffer->bo );
+#endif
+   }
+#ifdef HAVE_GBM
+   if ( gGbmDevice ) gbm_device_destroy( gGbmDevice );
+   if ( gDrmFd >= 0 ) close( gDrmFd );
+#endif
+   if ( gUploadTextures[0] ) glDeleteTextures( BUFFER_COUNT, gUploadTextures );
+   if ( gExternalProg ) glDeleteProgram( gExternalProg );
+   if ( g2DProg ) glDeleteProgram( g2DProg );
+   if ( gVbo ) glDeleteBuffers( 1, &gVbo );
+   free( gStaging );
+   free( gPatternRow );
+}
+
+// The CPU side producer: moving bars, every byte of the frame written.
+static void fillFrame( unsigned char *pixels, int stride, unsigned long frame )
+{
+   int shift= (int)((frame*8) % gWidth);
+
+   for( int y= 0; y < gHeight; ++y )
+   {
+      memcpy( pixels+(size_t)y*stride, gPatternRow+shift, gWidth*sizeof(unsigned int) );
+   }
+}
+
+static void syncDmabuf( FrameBuffer *buffer, unsigned long long flags )
+{
+   struct dma_buf_sync sync;
+
+   sync.flags= flags;
+   ioctl( buffer->dmabufFd, DMA_BUF_IOCTL_SYNC, &sync );
+}
+
+static void presentFrame(void)
+{
+   if ( gBackend != EglBackend_display )
+      eglBackendSwap( &gEglBackend );
+   else
+      EssContextUpdateDisplay( ctx );
+}
+
+static void renderFrame( PathStats *stats, bool dmabuf )
+{
+   unsigned long frame= stats->frames;
+   long long t0, t1, t2, now;
+
+   glViewport( 0, 0, gDisplayWidth, gDisplayHeight );
+
+   t0= currentTimeMicros();
+   if ( dmabuf )
+   {
+      FrameBuffer *buffer= &gBuffers[frame % BUFFER_COUNT];
+
+      syncDmabuf( buffer, DMA_BUF_SYNC_START|DMA_BUF_SYNC_WRITE );
+      fillFrame( (unsigned char*)buffer->map, buffer->stride, frame );
+      syncDmabuf( buffer, DMA_BUF_SYNC_END|DMA_BUF_SYNC_WRITE );
+      t1= currentTimeMicros();
+
+      glUseProgram( gExternalProg );
+      glBindTexture( GL_TEXTURE_EXTERNAL_OES, buffer->texture );
+   }
+   else
+   {
+      fillFrame( gStaging, gWidth*4, frame );
+      t1= currentTimeMicros();
+
+      glUseProgram( g2DProg );
+      glBindTexture( GL_TEXTURE_2D, gUploadTextures[frame % BUFFER_COUNT] );
+      glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, gWidth, gHeight, gUploadFormat, GL_UNSIGNED_BYTE, gStaging );
+   }
+   t2= currentTimeMicros();
+
+   glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+   presentFrame();
+   now= currentTimeMicros();
+
+   ++stats->frames;
+   stats->fillMs += (t1-t0)/1000.0;
+   stats->uploadMs += (t2-t1)/1000.0;
+   stats->bytes += (unsigned long long)gWidth*gHeight*4;
+   if ( stats->prevUs )
+   {
+      double ms= (now-stats->prevUs)/1000.0;
+
+      stats->frameMs += ms;
+      if ( ms > stats->frameMaxMs ) stats->frameMaxMs= ms;
+   }
+   stats->prevUs= now;
+}
+
+static void showStats( PathStats *stats, bool dmabuf )
+{
+   double fillSeconds= stats->fillMs/1000.0;
+   double uploadSeconds= stats->uploadMs/1000.0;
+
+   if ( stats->frames < 2 ) return;
+
+   // the dmabuf path copies nothing when handing over, its bandwidth is
+   // that of the CPU writing into the buffer; the upload path's is that of
+   // glTexSubImage2D
+   if ( dmabuf )
+   {
+      printf("%-7s %lu frames: write %.2f ms (%.1f MB/s into the dmabuf), hand over %.3f ms, frame %.2f ms avg %.2f ms max\n",
+             stats->name, stats->frames,
+             stats->fillMs/stats->frames,
+             (fillSeconds > 0.0) ? stats->bytes/fillSeconds/1000000.0 : 0.0,
+             stats->uploadMs/stats->frames,
+             stats->frameMs/(stats->frames-1), stats->frameMaxMs );
+   }
+   else
+   {
+      printf("%-7s %lu frames: write %.2f ms, upload %.3f ms (%.1f MB/s through glTexSubImage2D), frame %.2f ms avg %.2f ms max\n",
+             stats->name, stats->frames,
+             stats->fillMs/stats->frames,
+             stats->uploadMs/stats->frames,
+             (uploadSeconds > 0.0) ? stats->bytes/uploadSeconds/1000000.0 : 0.0,
+             stats->frameMs/(stats->frames-1), stats->frameMaxMs );
+   }
+}
+
+// Runs the enabled paths one after the other; pump is the event loop
+// step, 0 when headless.
+static void runPaths( void (*pump)(void) )
+{
+   gStats[0].name= "dmabuf";
+   gStats[1].name= "upload";
+
+   for( int path= 0; (path < 2) && gRunning; ++path )
+   {
+      if ( (path == 0) ? !gRunDmabuf : !gRunUpload ) continue;
+
+      while( gRunning && (gStats[path].frames < gFramesPerPath) )
+      {
+         renderFrame( &gStats[path], (path == 0) );
+         if ( pump ) pump();
+      }
+   }
+
+   for( int path= 0; path < 2; ++path )
+   {
+      showStats( &gStats[path], (path == 0) );
+   }
+}
+
+static void signalHandler(int signum)
+{
+   printf("signalHandler: signum %d\n", signum);
+   gRunning= false;
+}
+
+static void terminated( void * )
+{
+   printf("terminated event\n");
+   gRunning= false;
+}
+
+static EssTerminateListener terminateListener=
+{
+   terminated
+};
+
+static void displaySize( void *userData, int width, int height )
+{
+   EssCtx *ctx= (EssCtx*)userData;
+
+   if ( (gDisplayWidth != width) || (gDisplayHeight != height) )
+   {
+      printf("display size changed: %dx%d\n", width, height);
+      gDisplayWidth= width;
+      gDisplayHeight= height;
+      EssContextResizeWindow( ctx, width, height );
+   }
+}
+
+static EssSettingsListener settingsListener=
+{
+   displaySize
+};
+
+static void pumpEssos(void)
+{
+   EssContextRunEventLoopOnce( ctx );
+}
+
+int main( int argc, char **argv )
+{
+   int nRC= 0;
+   struct sigaction sigint;
+
+   loadEnv();
+
+   sigint.sa_handler= signalHandler;
+   sigemptyset(&sigint.sa_mask);
+   sigint.sa_flags= SA_RESETHAND;
+   sigaction(SIGINT, &sigint, NULL);
+
+   if ( gBackend != EglBackend_display )
+   {
+      if ( !eglBackendCreate( &gEglBackend, gBackend, gWidth, gHeight ) )
+      {
+         return -1;
+      }
+      gDisplayWidth= gWidth;
+      gDisplayHeight= gHeight;
+      gRunning= setupGL( gEglBackend.display );
+      if ( !gRunning )
+      {
+         nRC= -1;
+      }
+      runPaths( 0 );
+      termGL( gEglBackend.display );
+      eglBackendDestroy( &gEglBackend );
+      return nRC;
+   }
+
+   ctx= EssContextCreate();
+   if ( ctx )
+   {
+      bool error= false;
+
+      if ( !EssContextSetTerminateListener( ctx, 0, &terminateListener ) )
+      {
+         error= true;
+      }
+
+      if ( !EssContextSetSettingsListener( ctx, ctx, &settingsListener ) )
+      {
+         error= true;
+      }
+
+      if ( !EssContextInit( ctx ) )
+      {
+         error= true;
+      }
+
+      if ( !EssContextGetDisplaySize( ctx, &gDisplayWidth, &gDisplayHeight ) )
+      {
+         error= true;
+      }
+
+      if ( !error && !EssContextStart( ctx ) )
+      {
+         error= true;
+      }
+
+      if ( !error )
+      {
+         EGLDisplay display= eglGetCurrentDisplay();
+
+         gRunning= setupGL( display );
+         if ( !gRunning )
+         {
+            nRC= -1;
+         }
+         runPaths( pumpEssos );
+         termGL( display );
+      }
+      else
+      {
+         const char *detail= EssContextGetLastErrorDetail( ctx );
+         printf("Essos error: (%s)\n", detail );
+      }
+
+      EssContextDestroy( ctx );
+   }
+
+   return nRC;
+}
@@ -28,7 +28,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include "essos-app.h" 
+#include "dynamic-resolution.h"
+#include "egl-backend.h"
+#include "fill-bench.h"
+#include "frame-pacer.h"
 #include <signal.h>
 
 static EssCtx *ctx= 0;
@@ -42,6 +47,47 @@ static int32_t height = 1080;
 static EGLDisplay egl_display;
 static char running = 1;
 
+// render scheduling: gNeedsRender asks the pacer for a frame
+static bool gNeedsRender= true;
+static bool gAnimate= true;
+static int gTargetFps= 0;
+static int gIdleMs= 10;
+static FramePacer gPacer;
+
+// DYNAMIC_RESOLUTION=<fps> renders offscreen at a scale that keeps that rate
+static int gDynamicResolutionFps= 0;
+static float gDynamicResolutionMinScale= 0.5f;
+static DynamicResolution gDynamicResolution;
+
+// BACKEND=surfaceless|pbuffer|gbm renders headless instead of through Essos,
+// FRAMES=<n> stops after n frames
+static EglBackendType gBackend= EglBackend_display;
+static unsigned long gFrameLimit= 0;
+static unsigned long gFrameCount= 0;
+static unsigned long long gPixelsFilled= 0;
+static int gBytesPerPixel= 4;
+
+// BENCH=clear|quad|blend|texture|all replaces the plain clear with a fill
+// rate case, see fill-bench.h
+static const char *gBenchMode= 0;
+static int gBenchLayers= 4;
+static int gBenchTextureSize= 256;
+static unsigned long gBenchFrames= 300;
+static FillBench gBench;
+
+// SWAP_SWEEP=0,1,2 runs SWEEP_FRAMES frames at each swap interval and
+// reports throughput, swap call time and jank for each
+#define SWEEP_MAX_INTERVALS (8)
+static int gSweepIntervals[SWEEP_MAX_INTERVALS];
+static int gSweepCount= 0;
+static int gSweepIndex= 0;
+static unsigned long gSweepFrames= 300;
+static unsigned long gSweepFrame= 0;
+static long long gSweepStartUs= 0;
+static long long gSweepPrevUs= 0;
+static float *gSweepIntervalMs= 0;
+static float *gSweepSwapMs= 0;
+
 struct window {
 	EGLContext egl_context;
 	EGLSurface egl_surface;
@@ -54,6 +100,7 @@ static void show_fps() {
 	static time_t lastPrintTime = 0;
 	static time_t lastPrintFrame = 0;
 	static unsigned long frame = 0;
+	static unsigned long long lastPrintPixels = 0;
 
 	gettimeofday(&curTime, NULL);
 	nowMs =  curTime.tv_usec / 1000;
@@ -63,10 +110,14 @@ static void show_fps() {
 
 	if (nowMs - lastPrintTime >= 5000 || lastPrintFrame == 0) {
 		if (nowMs - lastPrintTime != 0 && lastPrintTime != 0) {
-			const float fps = (float) (frame - lastPrintFrame) / ((nowMs - lastPrintTime) / 1000.0f);
-			printf("FPS: %.2f\n", fps);
+			const float seconds = (nowMs - lastPrintTime) / 1000.0f;
+			const float fps = (float) (frame - lastPrintFrame) / seconds;
+			const double mbps = (gPixelsFilled - lastPrintPixels) * gBytesPerPixel / seconds / 1000000.0;
+			const double mpixels = (gPixelsFilled - lastPrintPixels) / seconds / 1000000.0;
+			printf("FPS: %.2f, fill %.1f Mpixels/s %.1f MB/s\n", fps, mpixels, mbps);
 		}
 
+		lastPrintPixels = gPixelsFilled;
 		lastPrintFrame = frame;
 		lastPrintTime  = nowMs;
 	}
@@ -75,8 +126,32 @@ static void show_fps() {
 static void draw_window (struct window *window) {
 	window->color = (window->color + 1) % 256;
 	float c = window->color / 255.0;
-	glClearColor (0.0, c, 0.0, 1.0);
-	glClear (GL_COLOR_BUFFER_BIT);
+
+	int render_width = gDisplayWidth;
+	int render_height = gDisplayHeight;
+
+	if (gDynamicResolutionFps > 0) {
+		dynamicResolutionBegin(&gDynamicResolution, gDisplayWidth, gDisplayHeight);
+		render_width = gDynamicResolution.renderWidth;
+		render_height = gDynamicResolution.renderHeight;
+	}
+
+	if (gBenchMode) {
+		gPixelsFilled += fillBenchDraw(&gBench, render_width, render_height);
+		if (fillBenchFinished(&gBench)) {
+			gRunning = false;
+		}
+	} else {
+		glClearColor (0.0, c, 0.0, 1.0);
+		glClear (GL_COLOR_BUFFER_BIT);
+		gPixelsFilled += (unsigned long long) render_width * render_height;
+	}
+
+	if (gDynamicResolutionFps > 0) {
+		dynamicResolutionEnd(&gDynamicResolution);
+		gPixelsFilled += (unsigned long long) gDisplayWidth * gDisplayHeight;
+	}
+	gFrameCount++;
 
 	show_fps();
 }
@@ -85,6 +160,18 @@ void load_env() {
 	const char *swap_str = getenv("SWAP_INTERVAL");
 	const char *width_str = getenv("WIDTH");
 	const char *height_str = getenv("HEIGHT");
+	const char *animate_str = getenv("ANIMATE");
+	const char *target_fps_str = getenv("TARGET_FPS");
+	const char *idle_ms_str = getenv("IDLE_MS");
+	const char *dynres_str = getenv("DYNAMIC_RESOLUTION");
+	const char *dynres_min_str = getenv("DYNRES_MIN_SCALE");
+	const char *backend_str = getenv("BACKEND");
+	const char *frames_str = getenv("FRAMES");
+	const char *layers_str = getenv("LAYERS");
+	const char *texture_size_str = getenv("TEXTURE_SIZE");
+	const char *bench_frames_str = getenv("BENCH_FRAMES");
+	const char *sweep_str = getenv("SWAP_SWEEP");
+	const char *sweep_frames_str = getenv("SWEEP_FRAMES");
 
 	if (swap_str) {
 		swap_interval = atoi(swap_str);
@@ -97,6 +184,83 @@ void load_env() {
 	if (height_str) {
 		height = atoi(height_str);
 	}
+
+	// ANIMATE=0 only renders on input or display changes
+	if (animate_str) {
+		gAnimate = atoi(animate_str) != 0;
+	}
+
+	// TARGET_FPS=<n> caps the frame rate, 0 leaves it to the swap interval
+	if (target_fps_str) {
+		gTargetFps = atoi(target_fps_str);
+	}
+
+	// IDLE_MS=<n> is how long to sleep between event polls with nothing to draw
+	if (idle_ms_str) {
+		gIdleMs = atoi(idle_ms_str);
+		if (gIdleMs < 1) gIdleMs = 1;
+	}
+
+	// DYNAMIC_RESOLUTION=<fps> scales the render size to hold that frame
+	// rate, DYNRES_MIN_SCALE=<f> is the lowest fraction of the display used
+	if (dynres_str) {
+		gDynamicResolutionFps = atoi(dynres_str);
+	}
+
+	if (dynres_min_str) {
+		gDynamicResolutionMinScale = atof(dynres_min_str);
+	}
+
+	// BACKEND=surfaceless|pbuffer|gbm runs headless at WIDTH x HEIGHT
+	if (backend_str) {
+		gBackend = eglBackendFromName(backend_str);
+	}
+
+	if (frames_str) {
+		gFrameLimit = strtoul(frames_str, NULL, 10);
+	}
+
+	// BENCH=<case> with LAYERS quads of overdraw, TEXTURE_SIZE texels for
+	// the texture case; BENCH=all runs each case for BENCH_FRAMES frames
+	gBenchMode = getenv("BENCH");
+
+	if (layers_str) {
+		gBenchLayers = atoi(layers_str);
+	}
+
+	if (texture_size_str) {
+		gBenchTextureSize = atoi(texture_size_str);
+	}
+
+	if (bench_frames_str) {
+		gBenchFrames = strtoul(bench_frames_str, NULL, 10);
+		if (gBenchFrames < 2) gBenchFrames = 2;
+	}
+
+	// SWAP_SWEEP=<list of swap intervals>, e.g. 0,1,2
+	if (sweep_str) {
+		char *end;
+		while (*sweep_str && gSweepCount < SWEEP_MAX_INTERVALS) {
+			long interval = strtol(sweep_str, &end, 10);
+			if (end == sweep_str) break;
+			gSweepIntervals[gSweepCount++] = (int) interval;
+			sweep_str = (*end == ',') ? end + 1 : end;
+		}
+	}
+
+	if (sweep_frames_str) {
+		gSweepFrames = strtoul(sweep_frames_str, NULL, 10);
+		if (gSweepFrames < 10) gSweepFrames = 10;
+	}
+}
+
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
 }
 
 static void signalHandler(int signum)
@@ -118,6 +282,7 @@ static EssTerminateListener terminateListener=
 
 static void keyPressed( void *, unsigned int key )
 {
+   gNeedsRender= true;
    switch( key )
    {
        default:
@@ -143,6 +308,7 @@ void displaySize( void *userData, int width, int height )
       printf("display size changed: %dx%d\n", width, height);
       gDisplayWidth= width;
       gDisplayHeight= height;
+      gNeedsRender= true;
       EssContextResizeWindow( ctx, width, height );
    }
 }
@@ -152,11 +318,246 @@ static EssSettingsListener settingsListener=
    displaySize
 };
 
+static void applySwapInterval( int interval )
+{
+   EGLDisplay display= eglGetCurrentDisplay();
+   EGLBoolean rv= eglSwapInterval( display, interval );
+
+   printf("%s = eglSwapInterval(%p, %d)\n", (rv == EGL_TRUE) ? "EGL_TRUE" : "EGL_FALSE", display, interval);
+}
+
+static int compareFloat( const void *a, const void *b )
+{
+   float fa= *(const float*)a, fb= *(const float*)b;
+
+   return (fa > fb) - (fa < fb);
+}
+
+// values must be sorted
+static float percentile( float *values, unsigned long count, double p )
+{
+   unsigned long index= (unsigned long)(p*(count-1)+0.5);
+
+   return values[index];
+}
+
+static void sweepReport(void)
+{
+   unsigned long count= gSweepFrame;
+   double seconds= (gSweepPrevUs-gSweepStartUs)/1000000.0;
+   double swapSum= 0;
+   float median;
+   unsigned long janks= 0;
+
+   qsort( gSweepIntervalMs, count, sizeof(float), compareFloat );
+   median= percentile( gSweepIntervalMs, count, 0.5 );
+   // a frame that took half a median frame longer missed its slot
+   for( unsigned long i= 0; i < count; ++i )
+   {
+      if ( gSweepIntervalMs[i] > median*1.5f ) ++janks;
+   }
+   for( unsigned long i= 0; i < count; ++i )
+   {
+      swapSum += gSweepSwapMs[i];
+   }
+   qsort( gSweepSwapMs, count, sizeof(float), compareFloat );
+
+   printf("swap interval %d: %.2f FPS, frame p50 %.2f p99 %.2f max %.2f ms, "
+          "swap call avg %.2f p99 %.2f ms, %lu janks%s\n",
+          gSweepIntervals[gSweepIndex], count/seconds,
+          median, percentile( gSweepIntervalMs, count, 0.99 ), gSweepIntervalMs[count-1],
+          swapSum/count, percentile( gSweepSwapMs, count, 0.99 ), janks,
+          (gSweepIntervals[gSweepIndex] == 0) ? ", may tear" : "" );
+}
+
+static void sweepStart( int index )
+{
+   gSweepIndex= index;
+   gSweepFrame= 0;
+   gSweepPrevUs= 0;
+   applySwapInterval( gSweepIntervals[index] );
+}
+
+// Times one presented frame; moves to the next interval when a run is
+// complete and stops the loop after the last.
+static void sweepRecord( long long beforeUs, long long afterUs )
+{
+   if ( gSweepPrevUs )
+   {
+      gSweepIntervalMs[gSweepFrame]= (afterUs-gSweepPrevUs)/1000.0f;
+      gSweepSwapMs[gSweepFrame]= (afterUs-beforeUs)/1000.0f;
+      ++gSweepFrame;
+   }
+   else
+   {
+      gSweepStartUs= afterUs;
+   }
+   gSweepPrevUs= afterUs;
+
+   if ( gSweepFrame == gSweepFrames )
+   {
+      sweepReport();
+      if ( gSweepIndex+1 < gSweepCount )
+         sweepStart( gSweepIndex+1 );
+      else
+         gRunning= false;
+   }
+}
+
+// backend is 0 when Essos owns the display
+static void presentFrame( EglBackend *backend )
+{
+   long long beforeUs= currentTimeMicros();
+
+   if ( backend )
+      eglBackendSwap( backend );
+   else
+      EssContextUpdateDisplay( ctx );
+
+   if ( gDynamicResolutionFps > 0 )
+   {
+      dynamicResolutionPresented( &gDynamicResolution );
+   }
+   if ( gSweepCount )
+   {
+      sweepRecord( beforeUs, currentTimeMicros() );
+   }
+}
+
+// GL resources of the optional modes, with the context current.
+static bool setupGL(void)
+{
+   if ( gSweepCount )
+   {
+      gSweepIntervalMs= (float*)malloc( gSweepFrames*sizeof(float) );
+      gSweepSwapMs= (float*)malloc( gSweepFrames*sizeof(float) );
+      if ( !gSweepIntervalMs || !gSweepSwapMs )
+      {
+         printf("no memory for %lu sweep frames\n", gSweepFrames);
+         return false;
+      }
+      printf("swap sweep: %d intervals, %lu frames each\n", gSweepCount, gSweepFrames);
+      sweepStart( 0 );
+   }
+   else
+   {
+      applySwapInterval( swap_interval );
+   }
+
+   if ( gDynamicResolutionFps > 0 )
+   {
+      if ( !dynamicResolutionInit( &gDynamicResolution, gDynamicResolutionFps, gDynamicResolutionMinScale ) )
+      {
+         printf("dynamic resolution unavailable, rendering at display size\n");
+         gDynamicResolutionFps= 0;
+      }
+   }
+
+   if ( gBenchMode )
+   {
+      if ( !fillBenchInit( &gBench, gBenchMode, gBenchLayers, gBenchTextureSize, gBenchFrames ) )
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+static void termGL(void)
+{
+   free( gSweepIntervalMs );
+   free( gSweepSwapMs );
+   gSweepIntervalMs= gSweepSwapMs= 0;
+
+   if ( gBenchMode )
+   {
+      fillBenchShowResults( &gBench );
+      fillBenchTerm( &gBench );
+   }
+
+   if ( gDynamicResolutionFps > 0 )
+   {
+      dynamicResolutionShowStats( &gDynamicResolution );
+      dynamicResolutionTerm( &gDynamicResolution );
+   }
+}
+
+static bool keepRunning(void)
+{
+   return gRunning && (!gFrameLimit || (gFrameCount < gFrameLimit));
+}
+
+static void showSummary( long long startUs )
+{
+   double seconds= (currentTimeMicros()-startUs)/1000000.0;
+
+   if ( seconds > 0.0 )
+   {
+      printf("%s: %lu frames in %.2f s, %.2f FPS, fill %.1f MB/s\n",
+             eglBackendName( gBackend ), gFrameCount, seconds, gFrameCount/seconds,
+             gPixelsFilled*gBytesPerPixel/seconds/1000000.0 );
+   }
+}
+
+// Same render loop as with Essos, on a headless EGL surface.
+static int runHeadless( struct window *window )
+{
+   EglBackend backend;
+   struct sigaction sigint;
+   long long startUs;
+
+   if ( !eglBackendCreate( &backend, gBackend, width, height ) )
+   {
+      return -1;
+   }
+   gDisplayWidth= width;
+   gDisplayHeight= height;
+   gBytesPerPixel= backend.bytesPerPixel;
+
+   if ( !setupGL() )
+   {
+      eglBackendDestroy( &backend );
+      return -1;
+   }
+
+   sigint.sa_handler= signalHandler;
+   sigemptyset(&sigint.sa_mask);
+   sigint.sa_flags= SA_RESETHAND;
+   sigaction(SIGINT, &sigint, NULL);
+
+   gRunning= true;
+   startUs= currentTimeMicros();
+   while( keepRunning() )
+   {
+      if ( framePacerDue( &gPacer, gNeedsRender ) )
+      {
+         draw_window( window );
+         presentFrame( &backend );
+         framePacerDone( &gPacer );
+         gNeedsRender= false;
+      }
+   }
+   showSummary( startUs );
+
+   termGL();
+   eglBackendDestroy( &backend );
+
+   return 0;
+}
+
 int main( int argc, char **argv )
 {
    int nRC= 0;
    struct window window;
+   window.color= 0;
    load_env();
+   framePacerInit( &gPacer, gAnimate, gTargetFps, gIdleMs );
+
+   if ( gBackend != EglBackend_display )
+   {
+      return runHeadless( &window );
+   }
 
    ctx= EssContextCreate();
 
@@ -203,15 +604,29 @@ int main( int argc, char **argv )
             error= true;
          }
 
+         if ( !error && !setupGL() )
+         {
+            error= true;
+         }
+
          if ( !error )
          {
+            long long startUs= currentTimeMicros();
+
             gRunning= true;
-            while( gRunning )
+            while( keepRunning() )
             {
-               draw_window (&window);
-               EssContextUpdateDisplay( ctx );
+               if ( framePacerDue( &gPacer, gNeedsRender ) )
+               {
+                  draw_window (&window);
+                  presentFrame( 0 );
+                  framePacerDone( &gPacer );
+                  gNeedsRender= false;
+               }
                EssContextRunEventLoopOnce( ctx );
             }
+            showSummary( startUs );
+            termGL();
          }
       }
 
@@ -18,6 +18,10 @@
  * limitations under the License.
  */
 #include "essos-app.h"
+#include "touch-tracker.h"
+#include "dynamic-resolution.h"
+#include "gamepad-tracker.h"
+#include "frame-pacer.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -26,12 +30,17 @@
 #include <math.h>
 #include <signal.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
 
+#include <atomic>
+
+#include <EGL/egl.h>
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 
 static EssCtx *ctx= 0;
-static bool gRunning;
+static std::atomic<bool> gRunning;
 static GLuint gProg= 0;
 static GLuint gFrag= 0;
 static GLuint gVert= 0;
@@ -45,16 +54,100 @@ static int gRow=1;
 static int gCol=1;
 static long long gStartTime;
 static long long gCurrTime;
-static int gTouchCount= 0;
-static int gTouch1ID= -1;
-static int gTouch1X;
-static int gTouch1Y;
-static int gTouch2ID= -1;
-static int gTouch2X;
-static int gTouch2Y;
+static TouchTracker gTouch;
+// triangle size: pinch scales it relative to the size it had when the
+// second finger went down
+static float gScale= 1.0f;
+static float gPinchBaseScale= 1.0f;
+static bool gPinching= false;
+static GamepadTracker gGamepads;
+static int gGamepadDeadZone= 25;
+static int gTriangleCount= 1;
+static GLuint gGeometryVbo= 0;
+static GLuint gGridPosVbo= 0;
+static GLuint gGridColorVbo= 0;
+static GLfloat *gGridOffsets= 0;
+static GLfloat *gGridPositions= 0;
+static float gGridScale;
+// render scheduling: gNeedsRender asks the pacer for a frame
+static std::atomic<bool> gNeedsRender( true );
+static bool gAnimate= true;
+static int gTargetFps= 0;
+static int gIdleMs= 10;
+static FramePacer gPacer;
+
+// Column-major 4x4 matrix, laid out as glUniformMatrix4fv expects and
+// aligned so the columns can be loaded as vectors.
+typedef struct _Mat4
+{
+   float m[16];
+} __attribute__((aligned(16))) Mat4;
+
+#define LATENCY_BIN_US (500)
+#define LATENCY_BINS (200)
+
+// Input-to-photon latency: input is stamped on receipt and the stamp is
+// handed to the renderer together with the state it changed; the frame that
+// picks both up carries the stamp and the latency is taken once that frame
+// has been swapped.
+static long long gPendingInputUs= 0;
+static std::atomic<long long> gPublishedInputUs( 0 );
+static long long gFrameInputUs= 0;
+static unsigned long gLatencyCount= 0;
+static long long gLatencyMinUs= 0;
+static long long gLatencyMaxUs= 0;
+static unsigned long gLatencyBins[LATENCY_BINS+1];
+
+// Everything the renderer needs from the input side. The input thread
+// fills one in after each pass of the Essos event loop.
+typedef struct _InputState
+{
+   int row;
+   int col;
+   int width;
+   int height;
+   float scale;
+} InputState;
+
+// Single-producer/single-consumer triple buffer: the input thread always owns
+// one slot to write and the render thread one to read; the third is swapped
+// through gSnapshotMiddle, whose SNAPSHOT_FRESH bit says it holds a state the
+// render thread has not seen yet.
+#define SNAPSHOT_FRESH (4)
+static InputState gSnapshots[3];
+static unsigned gSnapshotBack= 0;
+static unsigned gSnapshotFront= 2;
+static std::atomic<unsigned> gSnapshotMiddle( 1 );
+static bool gInputChanged= true;
+
+// THREADED=1 runs GL rendering on its own thread, the Essos event loop stays
+// on the main thread. GPU_LOAD=<n> adds n screen-covering draws per frame.
+static bool gThreaded= false;
+static int gGpuLoad= 0;
+static int gInputPollMs= 2;
+static EGLDisplay gEglDisplay= EGL_NO_DISPLAY;
+static EGLSurface gEglSurface= EGL_NO_SURFACE;
+static EGLContext gEglContext= EGL_NO_CONTEXT;
+
+// frame interval statistics, updated by whichever thread renders
+static unsigned long gFrameCount= 0;
+static double gFrameMeanMs= 0;
+static double gFrameM2= 0;
+static double gFrameMaxMs= 0;
+static long long gPrevFrameUs= 0;
+
+// DYNAMIC_RESOLUTION=<fps> renders offscreen at a scale that keeps that rate
+static int gDynamicResolutionFps= 0;
+static float gDynamicResolutionMinScale= 0.5f;
+static DynamicResolution gDynamicResolution;
 
 static bool setupGL(void);
-static bool renderGL(void);
+static bool renderGL( const InputState *state );
+static bool setupGeometry(void);
+static void bindGeometry(void);
+static void termGL(void);
+static void applyTouchGestures(void);
+static void applyGamepadAxes(void);
 
 
 static long long currentTimeMillis(void)
@@ -68,6 +161,314 @@ static long long currentTimeMillis(void)
    return utcCurrentTimeMillis;
 }
 
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
+}
+
+static void inputReceived(void)
+{
+   gInputChanged= true;
+   // only the oldest unanswered input counts until a frame shows it
+   if ( !gPendingInputUs )
+   {
+      gPendingInputUs= currentTimeMicros();
+   }
+}
+
+// Input thread: publish the current state if it changed, then hand over the
+// stamp of the input that caused it, unless an older one is still unclaimed.
+static void publishInputState(void)
+{
+   InputState *state;
+   long long expected= 0;
+
+   applyTouchGestures();
+   applyGamepadAxes();
+
+   if ( !gInputChanged ) return;
+   gInputChanged= false;
+
+   state= &gSnapshots[gSnapshotBack];
+   state->row= gRow;
+   state->col= gCol;
+   state->width= gDisplayWidth;
+   state->height= gDisplayHeight;
+   state->scale= gScale;
+   gSnapshotBack= gSnapshotMiddle.exchange( gSnapshotBack | SNAPSHOT_FRESH, std::memory_order_acq_rel ) & 3;
+   // only now ask for a frame: a request raised before the state is out
+   // could be cleared by a frame that still finds the old one
+   gNeedsRender= true;
+
+   if ( gPendingInputUs )
+   {
+      gPublishedInputUs.compare_exchange_strong( expected, gPendingInputUs, std::memory_order_acq_rel );
+      gPendingInputUs= 0;
+   }
+}
+
+// Render thread: claim the input stamp first, so the state picked up next is
+// at least as new as the input it stands for.
+static void consumeInputState( InputState *state )
+{
+   gFrameInputUs= gPublishedInputUs.exchange( 0, std::memory_order_acq_rel );
+
+   if ( gSnapshotMiddle.load( std::memory_order_relaxed ) & SNAPSHOT_FRESH )
+   {
+      gSnapshotFront= gSnapshotMiddle.exchange( gSnapshotFront, std::memory_order_acq_rel ) & 3;
+      *state= gSnapshots[gSnapshotFront];
+   }
+}
+
+static void recordFrameTime(void)
+{
+   long long now= currentTimeMicros();
+   double ms, delta;
+
+   if ( gPrevFrameUs )
+   {
+      ms= (now-gPrevFrameUs)/1000.0;
+      ++gFrameCount;
+      delta= ms-gFrameMeanMs;
+      gFrameMeanMs += delta/gFrameCount;
+      gFrameM2 += delta*(ms-gFrameMeanMs);
+      if ( ms > gFrameMaxMs ) gFrameMaxMs= ms;
+   }
+   gPrevFrameUs= now;
+}
+
+static void showFrameTimes(void)
+{
+   if ( gFrameCount < 2 ) return;
+
+   printf("frame time: %lu frames, mean %.2f ms stddev %.2f ms max %.2f ms\n",
+          gFrameCount, gFrameMeanMs, sqrt(gFrameM2/(gFrameCount-1)), gFrameMaxMs );
+}
+
+static void framePresented(void)
+{
+   long long latencyUs, bin;
+
+   if ( gFrameInputUs )
+   {
+      latencyUs= currentTimeMicros()-gFrameInputUs;
+      bin= latencyUs/LATENCY_BIN_US;
+
+      if ( !gLatencyCount || (latencyUs < gLatencyMinUs) ) gLatencyMinUs= latencyUs;
+      if ( latencyUs > gLatencyMaxUs ) gLatencyMaxUs= latencyUs;
+      ++gLatencyBins[(bin < LATENCY_BINS) ? bin : LATENCY_BINS];
+      ++gLatencyCount;
+
+      gFrameInputUs= 0;
+   }
+}
+
+static double latencyPercentile( double p )
+{
+   unsigned long target= gLatencyCount*p;
+   unsigned long count= 0;
+   int i;
+
+   for( i= 0; i < LATENCY_BINS; ++i )
+   {
+      count += gLatencyBins[i];
+      if ( count > target ) break;
+   }
+
+   // bin upper edge, but never above the largest sample seen
+   return ((i+1)*LATENCY_BIN_US < gLatencyMaxUs) ? (i+1)*LATENCY_BIN_US/1000.0 : gLatencyMaxUs/1000.0;
+}
+
+static void showInputLatency(void)
+{
+   if ( !gLatencyCount ) return;
+
+   printf("input latency: %lu samples, min %.2f ms p50 %.2f ms p90 %.2f ms p99 %.2f ms max %.2f ms\n",
+          gLatencyCount, gLatencyMinUs/1000.0,
+          latencyPercentile(0.50), latencyPercentile(0.90), latencyPercentile(0.99),
+          gLatencyMaxUs/1000.0 );
+   for( int i= 0; i <= LATENCY_BINS; ++i )
+   {
+      if ( gLatencyBins[i] )
+      {
+         printf("  %s%6.1f ms: %lu\n", (i == LATENCY_BINS) ? ">" : "<",
+                (i+(i < LATENCY_BINS))*LATENCY_BIN_US/1000.0, gLatencyBins[i] );
+      }
+   }
+}
+
+static void showFps(void)
+{
+   static long long lastPrintTime= 0;
+   static unsigned long lastPrintFrame= 0;
+   static unsigned long frame= 0;
+   long long nowMs= currentTimeMillis();
+
+   ++frame;
+
+   if ( (nowMs-lastPrintTime >= 5000) || (lastPrintFrame == 0) )
+   {
+      if ( lastPrintTime && (nowMs != lastPrintTime) )
+      {
+         float fps= (float)(frame-lastPrintFrame)/((nowMs-lastPrintTime)/1000.0f);
+         printf("FPS: %.2f (%d triangles)\n", fps, gTriangleCount );
+      }
+
+      lastPrintFrame= frame;
+      lastPrintTime= nowMs;
+   }
+}
+
+static void loadEnv(void)
+{
+   const char *env;
+
+   // TRIANGLES=<n> draws n spinning triangles in a grid instead of the
+   // single one moved by the arrow keys
+   env= getenv("TRIANGLES");
+   if ( env )
+   {
+      gTriangleCount= atoi(env);
+      if ( gTriangleCount < 1 ) gTriangleCount= 1;
+   }
+
+   env= getenv("THREADED");
+   if ( env )
+   {
+      gThreaded= (atoi(env) != 0);
+   }
+
+   env= getenv("GPU_LOAD");
+   if ( env )
+   {
+      gGpuLoad= atoi(env);
+   }
+
+   // INPUT_POLL_MS=<n> is the event loop period of the input thread
+   env= getenv("INPUT_POLL_MS");
+   if ( env )
+   {
+      gInputPollMs= atoi(env);
+      if ( gInputPollMs < 1 ) gInputPollMs= 1;
+   }
+
+   // DYNAMIC_RESOLUTION=<fps> scales the render size to hold that frame
+   // rate, DYNRES_MIN_SCALE=<f> is the lowest fraction of the display used
+   env= getenv("DYNAMIC_RESOLUTION");
+   if ( env )
+   {
+      gDynamicResolutionFps= atoi(env);
+   }
+
+   env= getenv("DYNRES_MIN_SCALE");
+   if ( env )
+   {
+      gDynamicResolutionMinScale= atof(env);
+   }
+
+   // GAMEPAD_DEADZONE=<percent> of an axis half range that is ignored
+   env= getenv("GAMEPAD_DEADZONE");
+   if ( env )
+   {
+      gGamepadDeadZone= atoi(env);
+   }
+
+   // ANIMATE=0 only renders on input or display changes
+   env= getenv("ANIMATE");
+   if ( env )
+   {
+      gAnimate= (atoi(env) != 0);
+   }
+
+   // TARGET_FPS=<n> caps the frame rate, 0 leaves it to the swap interval
+   env= getenv("TARGET_FPS");
+   if ( env )
+   {
+      gTargetFps= atoi(env);
+   }
+
+   // IDLE_MS=<n> is how long to sleep between event polls with nothing to draw
+   env= getenv("IDLE_MS");
+   if ( env )
+   {
+      gIdleMs= atoi(env);
+      if ( gIdleMs < 1 ) gIdleMs= 1;
+   }
+}
+
+static void renderFrame( InputState *state )
+{
+   // clear the request before taking the state, so input published while
+   // this frame renders asks for another one
+   gNeedsRender.exchange( false );
+   consumeInputState( state );
+   if ( gDynamicResolutionFps > 0 )
+   {
+      InputState scaled= *state;
+
+      dynamicResolutionBegin( &gDynamicResolution, state->width, state->height );
+      scaled.width= gDynamicResolution.renderWidth;
+      scaled.height= gDynamicResolution.renderHeight;
+      renderGL( &scaled );
+      dynamicResolutionEnd( &gDynamicResolution );
+      bindGeometry();
+   }
+   else
+   {
+      renderGL( state );
+   }
+   if ( gThreaded )
+   {
+      // keep Essos calls on the input thread, swap directly
+      eglSwapBuffers( gEglDisplay, gEglSurface );
+   }
+   else
+   {
+      EssContextUpdateDisplay( ctx );
+   }
+   if ( gDynamicResolutionFps > 0 )
+   {
+      dynamicResolutionPresented( &gDynamicResolution );
+   }
+   framePresented();
+   framePacerDone( &gPacer );
+   recordFrameTime();
+   showFps();
+}
+
+static void *renderThread( void * )
+{
+   InputState state;
+
+   memset( &state, 0, sizeof(state) );
+
+   if ( !eglMakeCurrent( gEglDisplay, gEglSurface, gEglSurface, gEglContext ) )
+   {
+      printf("renderThread: eglMakeCurrent failed: 0x%X\n", eglGetError() );
+      gRunning= false;
+      return 0;
+   }
+
+   setupGL();
+
+   while( gRunning )
+   {
+      if ( framePacerDue( &gPacer, gNeedsRender ) )
+      {
+         renderFrame( &state );
+      }
+   }
+
+   termGL();
+   eglMakeCurrent( gEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+   return 0;
+}
+
 static void signalHandler(int signum)
 {
    printf("signalHandler: signum %d\n", signum);
@@ -87,6 +488,7 @@ static EssTerminateListener terminateListener=
 
 static void keyPressed( void *, unsigned int key )
 {
+   inputReceived();
    switch( key )
    {
        case KEY_UP:
@@ -158,6 +560,7 @@ static void pointerMotion( void *, int, int )
 
 static void pointerButtonPressed( void *, int button, int x, int y )
 {
+   inputReceived();
    setTrianglePosition( x, y );
 }
 
@@ -174,61 +577,62 @@ static EssPointerListener pointerListener=
 
 static void touchDown( void *userData, int id, int x, int y )
 {
-   if ( gTouch1ID < 0 )
-   {
-      gTouchCount= 1;
-      gTouch1ID= id;
-      gTouch1X= x;
-      gTouch1Y= y;
-   }
-   else if  ( gTouch2ID < 0 )
-   {
-      gTouchCount= 2;
-      gTouch2ID= id;
-      gTouch2X= x;
-      gTouch2Y= y;
-   }
+   touchTrackerDown( &gTouch, id, x, y, currentTimeMillis() );
 }
 
 static void touchUp( void *userData, int id )
 {
-   if ( gTouch1ID == id )
-   {
-      --gTouchCount;
-      gTouch1ID= -1;
-   }
-   else if  ( gTouch2ID == id )
-   {
-      --gTouchCount;
-      gTouch2ID= -1;
-   }
+   touchTrackerUp( &gTouch, id, currentTimeMillis() );
 }
 
 static void touchMotion( void *userData, int id, int x, int y )
 {
-   if ( gTouch1ID == id )
-   {
-      gTouch1X= x;
-      gTouch1Y= y;
-   }
-   else if  ( gTouch2ID == id )
-   {
-      gTouch2X= x;
-      gTouch2Y= y;
-   }
+   // only the latest position is kept, gestures are evaluated once per frame
+   touchTrackerMotion( &gTouch, id, x, y );
 }
 
 static void touchFrame( void *userData )
 {
-   if ( gTouchCount == 1 )
+   inputReceived();
+}
+
+// Input thread, once per pass of the event loop: turn whatever the touch
+// events since the last pass amount to into one gesture.
+static void applyTouchGestures(void)
+{
+   TouchGesture gesture;
+
+   if ( !gTouch.pinching )
    {
-      setTrianglePosition( gTouch1X, gTouch1Y );
+      gPinching= false;
    }
-   else if ( gTouchCount == 2 )
+
+   if ( !touchTrackerUpdate( &gTouch, &gesture ) )
    {
-      setTrianglePosition( gDisplayWidth/2, gDisplayHeight/2 );
+      return;
    }
-   gTouchCount= 0;
+
+   switch( gesture.type )
+   {
+      case TouchGesture_tap:
+      case TouchGesture_drag:
+         setTrianglePosition( gesture.x, gesture.y );
+         break;
+      case TouchGesture_pinch:
+         if ( !gPinching )
+         {
+            gPinching= true;
+            gPinchBaseScale= gScale;
+         }
+         gScale= gPinchBaseScale*gesture.scale;
+         if ( gScale < 0.25f ) gScale= 0.25f;
+         if ( gScale > 3.0f ) gScale= 3.0f;
+         setTrianglePosition( gesture.x, gesture.y );
+         break;
+      default:
+         return;
+   }
+   gInputChanged= true;
 }
 
 static EssTouchListener touchListener=
@@ -249,6 +653,7 @@ void displaySize( void *userData, int width, int height )
 
       gDisplayWidth= width;
       gDisplayHeight= height;
+      gInputChanged= true;
 
       EssContextResizeWindow( ctx, width, height );
    }
@@ -258,9 +663,11 @@ static EssSettingsListener settingsListener=
 {
    displaySize
 };
-/*
-void gpButtonPressed( void *userData, int buttonId )
+#ifdef HAVE_ESSOS_GAMEPAD
+static void gpButtonPressed( void *userData, int buttonId )
 {
+   // buttons are discrete, every press counts
+   inputReceived();
    switch( buttonId )
    {
      case BTN_X:
@@ -292,43 +699,14 @@ void gpButtonPressed( void *userData, int buttonId )
    }
 }
 
-void gpButtonReleased( void *userData, int buttonId )
+static void gpButtonReleased( void *userData, int buttonId )
 {
 }
 
-void gpAxisChanged( void *userData, int axisId, int value )
+static void gpAxisChanged( void *userData, int axisId, int value )
 {
-   switch( axisId )
-   {
-      case ABS_X:
-      case ABS_Z:
-      case ABS_HAT0X:
-         if ( value > 0 )
-         {
-            gCol= gCol+1;
-            if ( gCol > 2 ) gCol= 2;
-         }
-         else
-         {
-            gCol= gCol-1;
-            if ( gCol < 0 ) gCol= 0;
-         }
-         break;
-      case ABS_Y:
-      case ABS_RZ:
-      case ABS_HAT0Y:
-         if ( value > 0 )
-         {
-            gRow= gRow+1;
-            if ( gRow > 2 ) gRow= 2;
-         }
-         else
-         {
-            gRow= gRow-1;
-            if ( gRow < 0 ) gRow= 0;
-         }
-         break;
-   }
+   // coalesced, applied once per pass by applyGamepadAxes
+   gamepadTrackerAxis( (GamepadDevice*)userData, axisId, value );
 }
 
 static EssGamepadEventListener gpEvent=
@@ -338,61 +716,60 @@ static EssGamepadEventListener gpEvent=
    gpAxisChanged
 };
 
-void gpConnected( void *userData, EssGamepad *gp )
+static void gpConnected( void *userData, EssGamepad *gp )
 {
    printf("gamepad %p connected\n", gp );
    if ( gp )
    {
+      GamepadDevice *device;
       const char *name= 0;
       unsigned int version= 0;
-      int buttonCount= 0;
-      int axisCount= 0;
-      int *buttonMap= 0;
-      int *axisMap= 0;
+
+      device= gamepadTrackerConnect( &gGamepads, gp );
+      if ( !device )
+      {
+         printf("gamepad %p ignored: already tracking %d gamepads\n", gp, GAMEPAD_MAX_DEVICES);
+         return;
+      }
 
       name= EssGamepadGetDeviceName( gp );
       version= EssGamepadGetDriverVersion( gp );
-      printf("gamepad %p name (%s) version (%X)\n", gp, name, version);
+      printf("gamepad %d: %p name (%s) version (%X)\n", device->index, gp, name, version);
+      if ( !gamepadTrackerReadRanges( device, name ) )
+      {
+         printf("gamepad %d: axis ranges unknown, assuming 8 bit axes until a wider value arrives\n", device->index);
+      }
 
-      EssGamepadGetButtonMap( gp, &buttonCount, NULL );
-      EssGamepadGetAxisMap( gp, &axisCount, NULL );
-      printf("gampad %p has %d buttons %d axes\n", gp, buttonCount, axisCount);
+      EssGamepadGetButtonMap( gp, &device->buttonCount, NULL );
+      EssGamepadGetAxisMap( gp, &device->axisCount, NULL );
+      printf("gamepad %d: %d buttons %d axes\n", device->index, device->buttonCount, device->axisCount);
 
-      if ( buttonCount > 0 )
+      if ( (device->buttonCount > 0) && (device->buttonCount <= GAMEPAD_MAX_BUTTONS) )
       {
-         buttonMap= (int*)calloc( buttonCount, sizeof(int) );
-         if ( buttonMap )
+         EssGamepadGetButtonMap( gp, &device->buttonCount, device->buttonMap );
+         for( int i= 0; i < device->buttonCount; ++i )
          {
-            EssGamepadGetButtonMap( gp, &buttonCount, buttonMap );
-            for( int i= 0; i < buttonCount; ++i )
-            {
-               printf("  button %d id 0x%x\n", i, buttonMap[i] );
-            }
-            free( buttonMap );
+            printf("  button %d id 0x%x\n", i, device->buttonMap[i] );
          }
       }
 
-      if ( axisCount > 0 )
+      if ( (device->axisCount > 0) && (device->axisCount <= GAMEPAD_MAX_AXES) )
       {
-         axisMap= (int*)calloc( axisCount, sizeof(int) );
-         if ( axisMap )
+         EssGamepadGetAxisMap( gp, &device->axisCount, device->axisMap );
+         for( int i= 0; i < device->axisCount; ++i )
          {
-            EssGamepadGetAxisMap( gp, &axisCount, axisMap );
-            for( int i= 0; i < axisCount; ++i )
-            {
-               printf("  axis %d id %d\n", i, axisMap[i] );
-            }
-            free( axisMap );
+            printf("  axis %d id %d\n", i, device->axisMap[i] );
          }
       }
 
-      EssGamepadSetEventListener( gp, userData, &gpEvent );
+      EssGamepadSetEventListener( gp, device, &gpEvent );
    }
 }
 
-void gpDisconnected( void *userData, EssGamepad *gp )
+static void gpDisconnected( void *userData, EssGamepad *gp )
 {
    printf("gamepad %p disconnected\n", gp );
+   gamepadTrackerDisconnect( &gGamepads, gp );
 }
 
 static EssGamepadConnectionListener gpConnectionListener=
@@ -400,12 +777,64 @@ static EssGamepadConnectionListener gpConnectionListener=
    gpConnected,
    gpDisconnected
 };
-*/
+#endif
+
+// Input thread, once per pass of the event loop: move the triangle one cell
+// when a stick or hat leaves its dead zone, however many events it sent.
+static void applyGamepadAxes(void)
+{
+#ifdef HAVE_ESSOS_GAMEPAD
+   GamepadAxisChange changes[GAMEPAD_MAX_DEVICES*4];
+   int count;
+
+   count= gamepadTrackerUpdate( &gGamepads, changes, sizeof(changes)/sizeof(changes[0]) );
+   for( int i= 0; i < count; ++i )
+   {
+      if ( changes[i].direction == 0 ) continue;
+
+      switch( changes[i].axisId )
+      {
+         case ABS_X:
+         case ABS_Z:
+         case ABS_HAT0X:
+            gCol= gCol+changes[i].direction;
+            if ( gCol > 2 ) gCol= 2;
+            if ( gCol < 0 ) gCol= 0;
+            inputReceived();
+            break;
+         case ABS_Y:
+         case ABS_RZ:
+         case ABS_HAT0Y:
+            gRow= gRow+changes[i].direction;
+            if ( gRow > 2 ) gRow= 2;
+            if ( gRow < 0 ) gRow= 0;
+            inputReceived();
+            break;
+         default:
+            break;
+      }
+   }
+#endif
+}
+
+static void showGamepadStats(void)
+{
+   if ( gGamepads.axisEvents )
+   {
+      printf("gamepad: %lu axis events, %lu axis updates\n",
+             gGamepads.axisEvents, gGamepads.axisUpdates );
+   }
+}
+
 int main( int argc, char **argv )
 {
    int nRC= 0;
 
    printf("ess-sample v1.0\n");
+   loadEnv();
+   touchTrackerInit( &gTouch );
+   gamepadTrackerInit( &gGamepads, gGamepadDeadZone );
+   framePacerInit( &gPacer, gAnimate, gTargetFps, gIdleMs );
    ctx= EssContextCreate();
    if ( ctx )
    {
@@ -451,12 +880,12 @@ int main( int argc, char **argv )
       {
          error= true;
       }
-/*
+#ifdef HAVE_ESSOS_GAMEPAD
       if ( !EssContextSetGamepadConnectionListener( ctx, ctx, &gpConnectionListener ) )
       {
          error= true;
       }
-*/
+#endif
       if ( !EssContextInit( ctx ) )
       {
          error= true;
@@ -487,17 +916,65 @@ int main( int argc, char **argv )
             error= true;
          }
 
-         if ( !error )
+         if ( !error && gThreaded )
          {
+            pthread_t renderThreadId;
+
+            // hand the context Essos created to the render thread
+            gEglDisplay= eglGetCurrentDisplay();
+            gEglSurface= eglGetCurrentSurface( EGL_DRAW );
+            gEglContext= eglGetCurrentContext();
+            eglMakeCurrent( gEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+            publishInputState();
+
+            gRunning= true;
+            if ( pthread_create( &renderThreadId, NULL, renderThread, NULL ) == 0 )
+            {
+               while( gRunning )
+               {
+                  EssContextRunEventLoopOnce( ctx );
+                  publishInputState();
+                  framePacerSleep( gInputPollMs*1000LL );
+               }
+               pthread_join( renderThreadId, NULL );
+            }
+            else
+            {
+               printf("unable to start render thread\n");
+               gRunning= false;
+            }
+
+            eglMakeCurrent( gEglDisplay, gEglSurface, gEglSurface, gEglContext );
+            showInputLatency();
+            showFrameTimes();
+            showGamepadStats();
+            dynamicResolutionShowStats( &gDynamicResolution );
+         }
+         else if ( !error )
+         {
+            InputState state;
+
+            memset( &state, 0, sizeof(state) );
             setupGL();
+            publishInputState();
 
             gRunning= true;
             while( gRunning )
             {
-               renderGL();
-               EssContextUpdateDisplay( ctx );
+               if ( framePacerDue( &gPacer, gNeedsRender ) )
+               {
+                  renderFrame( &state );
+               }
                EssContextRunEventLoopOnce( ctx );
+               publishInputState();
             }
+
+            showInputLatency();
+            showFrameTimes();
+            showGamepadStats();
+            dynamicResolutionShowStats( &gDynamicResolution );
+            termGL();
          }
       }
 
@@ -583,6 +1060,15 @@ static bool setupGL(void)
       goto exit;
    }
 
+   if ( gDynamicResolutionFps > 0 )
+   {
+      if ( !dynamicResolutionInit( &gDynamicResolution, gDynamicResolutionFps, gDynamicResolutionMinScale ) )
+      {
+         printf("dynamic resolution unavailable, rendering at display size\n");
+         gDynamicResolutionFps= 0;
+      }
+   }
+
    glUseProgram(gProg);
 
    gPos= 0;
@@ -595,60 +1081,235 @@ static bool setupGL(void)
    gOffset= glGetUniformLocation(gProg, "offset");
    gXform= glGetUniformLocation(gProg, "xform");
 
+   if ( !setupGeometry() )
+   {
+      goto exit;
+   }
+
    gStartTime= currentTimeMillis();
+   result= true;
 
 exit:
    return result;
 }
 
-static bool renderGL(void)
-{
-   static const GLfloat verts[3][2] = {
-      { -0.5, -0.5 },
-      {  0.5, -0.5 },
-      {  0.0,  0.5 }
-   };
-   static const GLfloat colors[3][4] = {
-      { 1, 0, 0, 1.0 },
-      { 0, 1, 0, 1.0 },
-      { 0, 0, 1, 1.0 }
-   };
-   GLfloat angle;
-   GLfloat matrix[4][4] = {
-      { 1, 0, 0, 0 },
-      { 0, 1, 0, 0 },
-      { 0, 0, 1, 0 },
-      { 0, 0, 0, 1 }
-   };
+static void mat4RotateY( Mat4 *mat, float angle, float scale )
+{
+   float c= scale*cosf(angle);
+   float sn= scale*sinf(angle);
+
+   memset( mat, 0, sizeof(Mat4) );
+   mat->m[0]= c;
+   mat->m[2]= sn;
+   mat->m[5]= scale;
+   mat->m[8]= -sn;
+   mat->m[10]= c;
+   mat->m[15]= 1.0f;
+}
+
+// Transforms count 2D points (z=0, w=1) by mat, out may not alias in.
+static void mat4TransformPoints( const Mat4 *mat, const float * __restrict in, float * __restrict out, int count )
+{
+   const float m0= mat->m[0], m1= mat->m[1], m4= mat->m[4], m5= mat->m[5];
+   const float m12= mat->m[12], m13= mat->m[13];
+
+   for( int i= 0; i < count; ++i )
+   {
+      float x= in[i*2];
+      float y= in[i*2+1];
+      out[i*2]= m0*x + m4*y + m12;
+      out[i*2+1]= m1*x + m5*y + m13;
+   }
+}
+
+static const GLfloat gTriangle[3][2]=
+{
+   { -0.5f, -0.5f },
+   {  0.5f, -0.5f },
+   {  0.0f,  0.5f }
+};
+
+static const GLfloat gTriangleColors[3][4]=
+{
+   { 1, 0, 0, 1.0 },
+   { 0, 1, 0, 1.0 },
+   { 0, 0, 1, 1.0 }
+};
+
+// All geometry lives in buffer objects and the attribute state is set up
+// once here; the program, the buffers and the enabled arrays stay bound
+// for the lifetime of the context.
+static bool setupGeometry(void)
+{
+   if ( gTriangleCount == 1 )
+   {
+      GLfloat interleaved[3][6];
+
+      for( int i= 0; i < 3; ++i )
+      {
+         memcpy( &interleaved[i][0], gTriangle[i], sizeof(gTriangle[i]) );
+         memcpy( &interleaved[i][2], gTriangleColors[i], sizeof(gTriangleColors[i]) );
+      }
+
+      glGenBuffers( 1, &gGeometryVbo );
+      glBindBuffer( GL_ARRAY_BUFFER, gGeometryVbo );
+      glBufferData( GL_ARRAY_BUFFER, sizeof(interleaved), interleaved, GL_STATIC_DRAW );
+   }
+   else
+   {
+      // Grid mode: one rotation shared by all triangles is applied to the
+      // three template vertices per frame and the per-triangle offsets are
+      // added while filling a streaming position buffer, drawn with a
+      // single call. Colors never change so they get their own static VBO.
+      int cols= (int)ceilf(sqrtf((float)gTriangleCount));
+      int vertexCount= gTriangleCount*3;
+      GLfloat *colors;
+
+      gGridScale= 1.0f/cols;
+      gGridOffsets= (GLfloat*)malloc( gTriangleCount*2*sizeof(GLfloat) );
+      gGridPositions= (GLfloat*)malloc( vertexCount*2*sizeof(GLfloat) );
+      colors= (GLfloat*)malloc( vertexCount*4*sizeof(GLfloat) );
+      if ( !gGridOffsets || !gGridPositions || !colors )
+      {
+         printf("setupGeometry: no memory for %d triangles\n", gTriangleCount);
+         free( colors );
+         return false;
+      }
+
+      for( int i= 0; i < gTriangleCount; ++i )
+      {
+         gGridOffsets[i*2]= -1.0f + (2*(i%cols)+1)*gGridScale;
+         gGridOffsets[i*2+1]= 1.0f - (2*(i/cols)+1)*gGridScale;
+         memcpy( &colors[i*12], gTriangleColors, sizeof(gTriangleColors) );
+      }
+
+      glGenBuffers( 1, &gGridColorVbo );
+      glBindBuffer( GL_ARRAY_BUFFER, gGridColorVbo );
+      glBufferData( GL_ARRAY_BUFFER, vertexCount*4*sizeof(GLfloat), colors, GL_STATIC_DRAW );
+      free( colors );
+
+      glGenBuffers( 1, &gGridPosVbo );
+      glBindBuffer( GL_ARRAY_BUFFER, gGridPosVbo );
+      glBufferData( GL_ARRAY_BUFFER, vertexCount*2*sizeof(GLfloat), NULL, GL_STREAM_DRAW );
+
+      Mat4 identity;
+      mat4RotateY( &identity, 0.0f, 1.0f );
+      glUniformMatrix4fv( gXform, 1, GL_FALSE, identity.m );
+      glUniform4f( gOffset, 0, 0, 0, 0 );
+   }
+
+   bindGeometry();
+
+   return true;
+}
+
+// Program, buffer bindings and attribute pointers renderGL relies on. Set
+// once, and again after anything else drew with its own state.
+static void bindGeometry(void)
+{
+   glUseProgram( gProg );
+
+   if ( gTriangleCount == 1 )
+   {
+      const GLsizei stride= 6*sizeof(GLfloat);
+
+      glBindBuffer( GL_ARRAY_BUFFER, gGeometryVbo );
+      glVertexAttribPointer( gPos, 2, GL_FLOAT, GL_FALSE, stride, (const void*)0 );
+      glVertexAttribPointer( gColor, 4, GL_FLOAT, GL_FALSE, stride, (const void*)(2*sizeof(GLfloat)) );
+   }
+   else
+   {
+      glBindBuffer( GL_ARRAY_BUFFER, gGridColorVbo );
+      glVertexAttribPointer( gColor, 4, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+      // left bound for the per-frame position upload
+      glBindBuffer( GL_ARRAY_BUFFER, gGridPosVbo );
+      glVertexAttribPointer( gPos, 2, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+   }
+
+   glEnableVertexAttribArray( gPos );
+   glEnableVertexAttribArray( gColor );
+}
+
+static void termGL(void)
+{
+   glDisableVertexAttribArray( gPos );
+   glDisableVertexAttribArray( gColor );
+   glBindBuffer( GL_ARRAY_BUFFER, 0 );
+   if ( gGeometryVbo ) glDeleteBuffers( 1, &gGeometryVbo );
+   if ( gGridPosVbo ) glDeleteBuffers( 1, &gGridPosVbo );
+   if ( gGridColorVbo ) glDeleteBuffers( 1, &gGridColorVbo );
+   free( gGridOffsets );
+   free( gGridPositions );
+   gGridOffsets= gGridPositions= 0;
+   if ( gDynamicResolutionFps > 0 ) dynamicResolutionTerm( &gDynamicResolution );
+   glDeleteProgram( gProg );
+   glDeleteShader( gFrag );
+   glDeleteShader( gVert );
+}
+
+static bool renderGL( const InputState *state )
+{
    static const uint32_t speed_div= 5;
-   EGLint rect[4];
+   float angle;
+   Mat4 matrix;
 
-   glViewport( 0, 0, gDisplayWidth, gDisplayHeight );
+   glViewport( 0, 0, state->width, state->height );
    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
    glClear(GL_COLOR_BUFFER_BIT);
 
    gCurrTime= currentTimeMillis();
 
-   angle= ((gCurrTime-gStartTime) / speed_div) % 360 * M_PI / 180.0;
-   matrix[0][0]= (1.0/3.0)*cos(angle);
-   matrix[0][2]= (1.0/3.0)*sin(angle);
-   matrix[1][1]= (1.0/3.0);
-   matrix[2][0]= -(1.0/3.0)*sin(angle);
-   matrix[2][2]= (1.0/3.0)*cos(angle);
+   angle= ((gCurrTime-gStartTime) / speed_div) % 360 * (float)M_PI / 180.0f;
 
-   glUniform4f(gOffset, -0.3333+gCol*0.3333, 0.3333-gRow*0.3333, 0, 0 );
-   glUniformMatrix4fv(gXform, 1, GL_FALSE, (GLfloat *)matrix);
+   if ( gTriangleCount == 1 )
+   {
+      if ( gGpuLoad > 0 )
+      {
+         // synthetic load: the triangle scaled up far enough to cover the screen
+         mat4RotateY( &matrix, 0.0f, 8.0f );
+         glUniform4f( gOffset, 0, 0, 0, 0 );
+         glUniformMatrix4fv( gXform, 1, GL_FALSE, matrix.m );
+         for( int i= 0; i < gGpuLoad; ++i )
+         {
+            glDrawArrays( GL_TRIANGLES, 0, 3 );
+         }
+      }
+
+      mat4RotateY( &matrix, angle, state->scale/3.0f );
+
+      glUniform4f(gOffset, -0.3333+state->col*0.3333, 0.3333-state->row*0.3333, 0, 0 );
+      glUniformMatrix4fv(gXform, 1, GL_FALSE, matrix.m);
+
+      glDrawArrays(GL_TRIANGLES, 0, 3);
+   }
+   else
+   {
+      GLfloat rotated[3][2];
 
-   glVertexAttribPointer(gPos, 2, GL_FLOAT, GL_FALSE, 0, verts);
-   glVertexAttribPointer(gColor, 4, GL_FLOAT, GL_FALSE, 0, colors);
-   glEnableVertexAttribArray(gPos);
-   glEnableVertexAttribArray(gColor);
+      mat4RotateY( &matrix, angle, gGridScale );
+      mat4TransformPoints( &matrix, &gTriangle[0][0], &rotated[0][0], 3 );
 
-   glDrawArrays(GL_TRIANGLES, 0, 3);
+      for( int i= 0; i < gTriangleCount; ++i )
+      {
+         const float ox= gGridOffsets[i*2];
+         const float oy= gGridOffsets[i*2+1];
+         GLfloat *out= &gGridPositions[i*6];
+
+         out[0]= rotated[0][0] + ox;
+         out[1]= rotated[0][1] + oy;
+         out[2]= rotated[1][0] + ox;
+         out[3]= rotated[1][1] + oy;
+         out[4]= rotated[2][0] + ox;
+         out[5]= rotated[2][1] + oy;
+      }
+
+      glBufferSubData( GL_ARRAY_BUFFER, 0, gTriangleCount*6*sizeof(GLfloat), gGridPositions );
+      for( int i= 0; i <= gGpuLoad; ++i )
+      {
+         glDrawArrays( GL_TRIANGLES, 0, gTriangleCount*3 );
+      }
+   }
 
-   glDisableVertexAttribArray(gPos);
-   glDisableVertexAttribArray(gColor);
-   
    GLenum err= glGetError();
    if ( err != GL_NO_ERROR )
    {
@@ -656,4 +1317,3 @@ static bool renderGL(void)
    }
    return true;
 }
-
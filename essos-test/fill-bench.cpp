@@ -0,0 +1,337 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fill-bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *modeNames[]= { "clear", "quad", "blend", "texture" };
+
+static const int sweepTextureSizes[]= { 64, 256, 1024, 2048 };
+
+static const char *vertSource=
+  "attribute vec2 pos;\n"
+  "uniform vec2 texelScale;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_Position= vec4(pos, 0.0, 1.0);\n"
+  "  uv= (pos*0.5+0.5)*texelScale;\n"
+  "}\n";
+
+static const char *colorSource=
+  "precision mediump float;\n"
+  "uniform vec4 color;\n"
+  "void main() {\n"
+  "  gl_FragColor= color;\n"
+  "}\n";
+
+static const char *textureSource=
+  "precision mediump float;\n"
+  "uniform sampler2D tex;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_FragColor= texture2D(tex, uv);\n"
+  "}\n";
+
+static const GLfloat quad[4][2]=
+{
+   { -1.0f, -1.0f },
+   {  1.0f, -1.0f },
+   { -1.0f,  1.0f },
+   {  1.0f,  1.0f }
+};
+
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
+}
+
+static GLuint createProgram( const char *fragSource )
+{
+   const char *sources[2]= { vertSource, fragSource };
+   GLenum types[2]= { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+   GLuint prog= glCreateProgram();
+   GLint status;
+
+   for( int i= 0; i < 2; ++i )
+   {
+      GLuint shader= glCreateShader( types[i] );
+
+      glShaderSource( shader, 1, &sources[i], NULL );
+      glCompileShader( shader );
+      glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+      if ( !status )
+      {
+         char log[1000];
+         GLsizei len;
+         glGetShaderInfoLog( shader, sizeof(log), &len, log );
+         printf("fillBench: compiling shader:\n%.*s\n", len, log);
+      }
+      glAttachShader( prog, shader );
+      glDeleteShader( shader );
+   }
+   glBindAttribLocation( prog, 0, "pos" );
+   glLinkProgram( prog );
+   glGetProgramiv( prog, GL_LINK_STATUS, &status );
+   if ( !status )
+   {
+      glDeleteProgram( prog );
+      prog= 0;
+   }
+   return prog;
+}
+
+// Checkerboard with 8 texel squares, power of two sized so it can repeat.
+static void loadTexture( FillBench *bench, int size )
+{
+   unsigned char *pixels;
+
+   if ( size == bench->textureSize ) return;
+
+   pixels= (unsigned char*)malloc( size*size*4 );
+   if ( !pixels ) return;
+   for( int y= 0; y < size; ++y )
+   {
+      for( int x= 0; x < size; ++x )
+      {
+         unsigned char *p= &pixels[(y*size+x)*4];
+         unsigned char v= (((x>>3)^(y>>3))&1) ? 0xFF : 0x40;
+
+         p[0]= v;
+         p[1]= (unsigned char)(x*255/size);
+         p[2]= (unsigned char)(y*255/size);
+         p[3]= 0xFF;
+      }
+   }
+   glBindTexture( GL_TEXTURE_2D, bench->texture );
+   glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
+   free( pixels );
+   bench->textureSize= size;
+}
+
+static void addCase( FillBench *bench, FillBenchMode mode, int textureSize )
+{
+   FillBenchCase *benchCase= &bench->cases[bench->caseCount++];
+
+   memset( benchCase, 0, sizeof(FillBenchCase) );
+   benchCase->mode= mode;
+   benchCase->textureSize= textureSize;
+}
+
+static bool isPowerOfTwo( int n )
+{
+   return (n > 0) && !(n & (n-1));
+}
+
+bool fillBenchInit( FillBench *bench, const char *mode, int layers, int textureSize, unsigned long framesPerCase )
+{
+   memset( bench, 0, sizeof(FillBench) );
+   bench->layers= (layers > 0) ? layers : 1;
+   bench->framesPerCase= framesPerCase;
+   if ( !isPowerOfTwo( textureSize ) )
+   {
+      printf("fillBench: TEXTURE_SIZE %d is not a power of two, using 256\n", textureSize);
+      textureSize= 256;
+   }
+
+   if ( !strcmp( mode, "all" ) )
+   {
+      addCase( bench, FillBench_clear, 0 );
+      addCase( bench, FillBench_quad, 0 );
+      addCase( bench, FillBench_blend, 0 );
+      for( unsigned i= 0; i < sizeof(sweepTextureSizes)/sizeof(sweepTextureSizes[0]); ++i )
+      {
+         addCase( bench, FillBench_texture, sweepTextureSizes[i] );
+      }
+   }
+   else
+   {
+      for( int i= 0; i < (int)(sizeof(modeNames)/sizeof(modeNames[0])); ++i )
+      {
+         if ( !strcmp( mode, modeNames[i] ) )
+         {
+            addCase( bench, (FillBenchMode)i, textureSize );
+         }
+      }
+      // a single case runs until the sample stops
+      bench->framesPerCase= 0;
+   }
+   if ( !bench->caseCount )
+   {
+      printf("fillBench: unknown BENCH mode (%s)\n", mode);
+      return false;
+   }
+
+   bench->colorProg= createProgram( colorSource );
+   bench->textureProg= createProgram( textureSource );
+   if ( !bench->colorProg || !bench->textureProg )
+   {
+      fillBenchTerm( bench );
+      return false;
+   }
+   bench->color= glGetUniformLocation( bench->colorProg, "color" );
+   bench->texelScale= glGetUniformLocation( bench->textureProg, "texelScale" );
+   glUseProgram( bench->textureProg );
+   glUniform1i( glGetUniformLocation( bench->textureProg, "tex" ), 0 );
+
+   glGenBuffers( 1, &bench->vbo );
+   glBindBuffer( GL_ARRAY_BUFFER, bench->vbo );
+   glBufferData( GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW );
+   glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+   glEnableVertexAttribArray( 0 );
+
+   glGenTextures( 1, &bench->texture );
+   glBindTexture( GL_TEXTURE_2D, bench->texture );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+
+   printf("fill bench: %s, %d layers, %d cases\n", mode, bench->layers, bench->caseCount);
+
+   return true;
+}
+
+void fillBenchTerm( FillBench *bench )
+{
+   if ( bench->vbo ) glDeleteBuffers( 1, &bench->vbo );
+   if ( bench->texture ) glDeleteTextures( 1, &bench->texture );
+   if ( bench->colorProg ) glDeleteProgram( bench->colorProg );
+   if ( bench->textureProg ) glDeleteProgram( bench->textureProg );
+   bench->vbo= bench->texture= bench->colorProg= bench->textureProg= 0;
+}
+
+unsigned long long fillBenchDraw( FillBench *bench, int width, int height )
+{
+   FillBenchCase *benchCase;
+   unsigned long long area= (unsigned long long)width*height;
+   unsigned long long pixels= 0;
+   long long now= currentTimeMicros();
+
+   benchCase= &bench->cases[bench->current];
+
+   // the case is over once its last frame has been swapped, i.e. when
+   // the next frame starts
+   if ( bench->framesPerCase && (benchCase->frames == bench->framesPerCase) )
+   {
+      if ( bench->current == bench->caseCount-1 ) return 0;
+      benchCase->endUs= now;
+      benchCase= &bench->cases[++bench->current];
+   }
+   // the first frame of a case is a warm up (shader compile, texture
+   // upload), timing starts with the second
+   if ( benchCase->frames == 1 )
+   {
+      benchCase->startUs= now;
+      benchCase->pixels= 0;
+   }
+
+   // state is set every frame, the caller may draw with its own in between
+   // and the surface may have been resized since the last one
+   glViewport( 0, 0, width, height );
+   glUseProgram( (benchCase->mode == FillBench_texture) ? bench->textureProg : bench->colorProg );
+   glBindBuffer( GL_ARRAY_BUFFER, bench->vbo );
+   glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, (const void*)0 );
+   glEnableVertexAttribArray( 0 );
+
+   switch( benchCase->mode )
+   {
+      case FillBench_clear:
+         glClearColor( 0.0f, (benchCase->frames & 0xFF)/255.0f, 0.0f, 1.0f );
+         glClear( GL_COLOR_BUFFER_BIT );
+         pixels= area;
+         break;
+      case FillBench_quad:
+      case FillBench_blend:
+         if ( benchCase->mode == FillBench_blend )
+         {
+            glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+            glClear( GL_COLOR_BUFFER_BIT );
+            pixels= area;
+            glEnable( GL_BLEND );
+            glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+         }
+         for( int i= 0; i < bench->layers; ++i )
+         {
+            glUniform4f( bench->color, (float)(i+1)/bench->layers, 0.5f, (benchCase->frames & 0xFF)/255.0f, 0.25f );
+            glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+         }
+         glDisable( GL_BLEND );
+         pixels += area*bench->layers;
+         break;
+      case FillBench_texture:
+         loadTexture( bench, benchCase->textureSize );
+         glActiveTexture( GL_TEXTURE0 );
+         glBindTexture( GL_TEXTURE_2D, bench->texture );
+         glUniform2f( bench->texelScale,
+                      (float)width/benchCase->textureSize,
+                      (float)height/benchCase->textureSize );
+         for( int i= 0; i < bench->layers; ++i )
+         {
+            glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+         }
+         pixels= area*bench->layers;
+         break;
+   }
+
+   ++benchCase->frames;
+   benchCase->pixels += pixels;
+   benchCase->endUs= now;
+
+   return pixels;
+}
+
+bool fillBenchFinished( FillBench *bench )
+{
+   return bench->framesPerCase &&
+          (bench->current == bench->caseCount-1) &&
+          (bench->cases[bench->current].frames >= bench->framesPerCase);
+}
+
+void fillBenchShowResults( FillBench *bench )
+{
+   printf("fill bench results (%d layers):\n", bench->layers);
+   for( int i= 0; i < bench->caseCount; ++i )
+   {
+      FillBenchCase *benchCase= &bench->cases[i];
+      double seconds= (benchCase->endUs-benchCase->startUs)/1000000.0;
+      // a finished case is timed up to the start of the next one, the
+      // current one only up to the start of its last frame
+      unsigned long counted= benchCase->frames-1;
+      unsigned long timed= (i < bench->current) ? counted : counted-1;
+      char name[32];
+
+      if ( (benchCase->frames < 3) || !timed || (seconds <= 0.0) ) continue;
+
+      if ( benchCase->mode == FillBench_texture )
+         snprintf( name, sizeof(name), "texture %d", benchCase->textureSize );
+      else
+         snprintf( name, sizeof(name), "%s", modeNames[benchCase->mode] );
+
+      printf("  %-14s %6lu frames %8.2f FPS %10.1f Mpixels/s\n",
+             name, benchCase->frames, timed/seconds,
+             ((double)benchCase->pixels*timed/counted)/seconds/1000000.0 );
+   }
+}
@@ -0,0 +1,91 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FILL_BENCH_H
+#define _FILL_BENCH_H
+
+#ifdef HAVE_EPOXY
+#  include <epoxy/gl.h>
+#else
+#  include <GLES2/gl2.h>
+#endif
+
+/*
+ * Fill rate and overdraw cases:
+ *
+ *  clear    glClear only
+ *  quad     LAYERS opaque full screen quads
+ *  blend    LAYERS alpha blended full screen quads over a clear
+ *  texture  LAYERS full screen quads sampling a TEXTURE_SIZE texture,
+ *           repeated so that one texel lands on one pixel
+ *  all      every case in turn, textures at 64 to 2048 texels, for
+ *           BENCH_FRAMES frames each, then a table of the results
+ */
+
+#define FILL_BENCH_MAX_CASES (8)
+
+typedef enum _FillBenchMode
+{
+   FillBench_clear,
+   FillBench_quad,
+   FillBench_blend,
+   FillBench_texture
+} FillBenchMode;
+
+typedef struct _FillBenchCase
+{
+   FillBenchMode mode;
+   int textureSize;
+   unsigned long frames;
+   // written since timing started with the second frame
+   unsigned long long pixels;
+   long long startUs;
+   long long endUs;
+} FillBenchCase;
+
+typedef struct _FillBench
+{
+   int layers;
+   unsigned long framesPerCase;
+   int caseCount;
+   int current;
+   FillBenchCase cases[FILL_BENCH_MAX_CASES];
+   GLuint colorProg;
+   GLuint textureProg;
+   GLint color;
+   GLint texelScale;
+   GLuint vbo;
+   GLuint texture;
+   int textureSize;
+} FillBench;
+
+// Needs a current context. mode is a BENCH value; returns false for an
+// unknown mode or if the GL setup fails.
+bool fillBenchInit( FillBench *bench, const char *mode, int layers, int textureSize, unsigned long framesPerCase );
+void fillBenchTerm( FillBench *bench );
+
+// Draws one frame of the current case into a width x height viewport and
+// returns the number of pixels written.
+unsigned long long fillBenchDraw( FillBench *bench, int width, int height );
+
+// True once a sweep has run all its cases.
+bool fillBenchFinished( FillBench *bench );
+
+void fillBenchShowResults( FillBench *bench );
+
+#endif
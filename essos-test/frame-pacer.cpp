@@ -0,0 +1,83 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "frame-pacer.h"
+
+#include <time.h>
+
+static long long currentTimeMicros(void)
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+
+   return ts.tv_sec*1000000LL+(ts.tv_nsec/1000LL);
+}
+
+void framePacerInit( FramePacer *pacer, bool animate, int targetFps, int idleMs )
+{
+   pacer->animate= animate;
+   pacer->targetFps= (targetFps > 0) ? targetFps : 0;
+   pacer->idleMs= (idleMs >= 1) ? idleMs : 1;
+   pacer->lastFrameUs= 0;
+}
+
+void framePacerSleep( long long us )
+{
+   struct timespec ts;
+
+   ts.tv_sec= us/1000000LL;
+   ts.tv_nsec= (us%1000000LL)*1000LL;
+   nanosleep( &ts, 0 );
+}
+
+bool framePacerDue( FramePacer *pacer, bool needsRender )
+{
+   long long idleUs= pacer->idleMs*1000LL;
+   long long waitUs;
+
+   if ( !pacer->animate && !needsRender )
+   {
+      framePacerSleep( idleUs );
+      return false;
+   }
+
+   if ( pacer->targetFps > 0 )
+   {
+      waitUs= pacer->lastFrameUs + 1000000LL/pacer->targetFps - currentTimeMicros();
+      if ( waitUs > 0 )
+      {
+         framePacerSleep( (waitUs < idleUs) ? waitUs : idleUs );
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void framePacerDone( FramePacer *pacer )
+{
+   long long now= currentTimeMicros();
+   long long period= (pacer->targetFps > 0) ? 1000000LL/pacer->targetFps : 0;
+
+   // keep to the frame grid unless we fell more than a frame behind
+   if ( pacer->lastFrameUs + period < now - period )
+      pacer->lastFrameUs= now;
+   else
+      pacer->lastFrameUs += period;
+}
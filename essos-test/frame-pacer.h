@@ -0,0 +1,56 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FRAME_PACER_H
+#define _FRAME_PACER_H
+
+/*
+ * Render scheduling shared by the Essos samples: a frame is drawn when
+ * something changed (input, display size) or while animating, at most
+ * targetFps times a second.
+ *
+ * Essos has no call that blocks until an event arrives, so when no frame is
+ * due the pacer sleeps for at most idleMs and the caller goes back to
+ * processing events.
+ */
+
+typedef struct _FramePacer
+{
+   // false renders only when the caller asks for a frame
+   bool animate;
+   // 0 leaves the rate to the swap interval
+   int targetFps;
+   int idleMs;
+   long long lastFrameUs;
+} FramePacer;
+
+void framePacerInit( FramePacer *pacer, bool animate, int targetFps, int idleMs );
+
+// Returns true when a frame should be rendered now, needsRender being
+// whether the caller has something new to show. Otherwise it sleeps and
+// returns false.
+bool framePacerDue( FramePacer *pacer, bool needsRender );
+
+// Called once the frame has been presented.
+void framePacerDone( FramePacer *pacer );
+
+// Sleeps for us microseconds; a signal ends the sleep early so the caller
+// can see it.
+void framePacerSleep( long long us );
+
+#endif
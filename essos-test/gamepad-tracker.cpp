@@ -0,0 +1,221 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gamepad-tracker.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Essos does not report axis ranges, and evdev only reports an axis when
+// it changes, so its first value is usually a deflection rather than the
+// rest position. Without a range from the device node an axis is taken to
+// be an 8 bit one; a value outside 0..255 marks it as a wider, signed axis
+// resting at 0. Either way the range grows if the axis moves further.
+#define GAMEPAD_8BIT_MIN (0)
+#define GAMEPAD_8BIT_MAX (255)
+#define GAMEPAD_DEFAULT_HALF_RANGE (128)
+
+static bool isHat( int axisId )
+{
+   return (axisId >= ABS_HAT0X) && (axisId <= ABS_HAT3Y);
+}
+
+void gamepadTrackerInit( GamepadTracker *tracker, int deadZonePercent )
+{
+   memset( tracker, 0, sizeof(GamepadTracker) );
+   if ( (deadZonePercent < 0) || (deadZonePercent > 95) )
+   {
+      deadZonePercent= 25;
+   }
+   tracker->deadZone= deadZonePercent;
+   for( int i= 0; i < GAMEPAD_MAX_DEVICES; ++i )
+   {
+      tracker->devices[i].index= i;
+   }
+}
+
+GamepadDevice* gamepadTrackerConnect( GamepadTracker *tracker, void *handle )
+{
+   for( int i= 0; i < GAMEPAD_MAX_DEVICES; ++i )
+   {
+      GamepadDevice *device= &tracker->devices[i];
+
+      if ( !device->connected )
+      {
+         memset( device, 0, sizeof(GamepadDevice) );
+         device->index= i;
+         device->connected= true;
+         device->handle= handle;
+         for( int axisId= 0; axisId < GAMEPAD_MAX_AXES; ++axisId )
+         {
+            device->center[axisId]= (GAMEPAD_8BIT_MIN+GAMEPAD_8BIT_MAX)/2;
+            device->halfRange[axisId]= GAMEPAD_DEFAULT_HALF_RANGE;
+         }
+         return device;
+      }
+   }
+   return 0;
+}
+
+void gamepadTrackerDisconnect( GamepadTracker *tracker, void *handle )
+{
+   for( int i= 0; i < GAMEPAD_MAX_DEVICES; ++i )
+   {
+      GamepadDevice *device= &tracker->devices[i];
+
+      if ( device->connected && (device->handle == handle) )
+      {
+         device->connected= false;
+         device->handle= 0;
+         device->dirty= 0;
+      }
+   }
+}
+
+void gamepadTrackerSetRange( GamepadDevice *device, int axisId, int min, int max )
+{
+   if ( (axisId >= 0) && (axisId < GAMEPAD_MAX_AXES) && (max > min) )
+   {
+      device->center[axisId]= min+(max-min)/2;
+      device->halfRange[axisId]= (max-min+1)/2;
+      device->ranged |= (1ULL << axisId);
+   }
+}
+
+bool gamepadTrackerReadRanges( GamepadDevice *device, const char *name )
+{
+   DIR *dir;
+   struct dirent *entry;
+   bool found= false;
+
+   if ( !name ) return false;
+
+   dir= opendir( "/dev/input" );
+   if ( !dir ) return false;
+
+   while ( !found && (entry= readdir( dir )) )
+   {
+      char path[PATH_MAX];
+      char nodeName[256];
+      unsigned long absBits[(ABS_CNT+8*sizeof(long)-1)/(8*sizeof(long))];
+      int fd;
+
+      if ( strncmp( entry->d_name, "event", 5 ) ) continue;
+
+      snprintf( path, sizeof(path), "/dev/input/%s", entry->d_name );
+      fd= open( path, O_RDONLY|O_CLOEXEC );
+      if ( fd < 0 ) continue;
+
+      memset( nodeName, 0, sizeof(nodeName) );
+      memset( absBits, 0, sizeof(absBits) );
+      if ( (ioctl( fd, EVIOCGNAME(sizeof(nodeName)-1), nodeName ) >= 0) &&
+           !strcmp( nodeName, name ) &&
+           (ioctl( fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits ) >= 0) )
+      {
+         for( int axisId= 0; axisId < GAMEPAD_MAX_AXES; ++axisId )
+         {
+            struct input_absinfo info;
+
+            if ( !(absBits[axisId/(8*sizeof(long))] & (1UL << (axisId%(8*sizeof(long))))) ) continue;
+            if ( ioctl( fd, EVIOCGABS(axisId), &info ) < 0 ) continue;
+            gamepadTrackerSetRange( device, axisId, info.minimum, info.maximum );
+         }
+         found= true;
+      }
+      close( fd );
+   }
+   closedir( dir );
+
+   return found;
+}
+
+void gamepadTrackerAxis( GamepadDevice *device, int axisId, int value )
+{
+   if ( (axisId >= 0) && (axisId < GAMEPAD_MAX_AXES) )
+   {
+      device->value[axisId]= value;
+      device->dirty |= (1ULL << axisId);
+      ++device->axisEvents;
+   }
+}
+
+int gamepadTrackerUpdate( GamepadTracker *tracker, GamepadAxisChange *changes, int maxChanges )
+{
+   int count= 0;
+
+   for( int i= 0; i < GAMEPAD_MAX_DEVICES; ++i )
+   {
+      GamepadDevice *device= &tracker->devices[i];
+
+      while ( device->dirty && (count < maxChanges) )
+      {
+         int axisId= __builtin_ctzll( device->dirty );
+         uint64_t bit= (1ULL << axisId);
+         int value= device->value[axisId];
+         int direction= 0;
+
+         device->dirty &= ~bit;
+         ++tracker->axisUpdates;
+
+         if ( isHat( axisId ) )
+         {
+            direction= (value > 0) - (value < 0);
+         }
+         else
+         {
+            int offset, magnitude, threshold;
+
+            if ( !((device->ranged|device->wide) & bit) &&
+                 ((value < GAMEPAD_8BIT_MIN) || (value > GAMEPAD_8BIT_MAX)) )
+            {
+               device->wide |= bit;
+               device->center[axisId]= 0;
+            }
+            offset= value-device->center[axisId];
+            magnitude= (offset < 0) ? -offset : offset;
+            if ( magnitude > device->halfRange[axisId] )
+            {
+               device->halfRange[axisId]= magnitude;
+            }
+            threshold= (device->halfRange[axisId]*tracker->deadZone)/100;
+            if ( magnitude > threshold )
+            {
+               direction= (offset > 0) ? 1 : -1;
+            }
+         }
+
+         if ( direction != device->direction[axisId] )
+         {
+            device->direction[axisId]= direction;
+            changes[count].device= device;
+            changes[count].axisId= axisId;
+            changes[count].direction= direction;
+            ++count;
+         }
+      }
+      tracker->axisEvents += device->axisEvents;
+      device->axisEvents= 0;
+   }
+
+   return count;
+}
@@ -0,0 +1,102 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _GAMEPAD_TRACKER_H
+#define _GAMEPAD_TRACKER_H
+
+#include <stdint.h>
+#include <linux/input.h>
+
+/*
+ * Axis state for a fixed number of gamepads.
+ *
+ * Controllers report axes far more often than frames are drawn, so an axis
+ * event only stores the latest raw value and marks the axis dirty. Once per
+ * frame gamepadTrackerUpdate runs the dead zone over the dirty axes only and
+ * reports the axes whose direction changed. All storage is part of the
+ * tracker; nothing is allocated when controllers come and go.
+ */
+
+#define GAMEPAD_MAX_DEVICES (4)
+#define GAMEPAD_MAX_BUTTONS (64)
+#define GAMEPAD_MAX_AXES (ABS_CNT)
+
+typedef struct _GamepadDevice
+{
+   bool connected;
+   void *handle;
+   int index;
+   // button and axis codes as reported by the device; a map that does not
+   // fit is left empty with its count still set
+   int buttonCount;
+   int buttonMap[GAMEPAD_MAX_BUTTONS];
+   int axisCount;
+   int axisMap[GAMEPAD_MAX_AXES];
+   // per evdev axis code; center is the rest position
+   int value[GAMEPAD_MAX_AXES];
+   int center[GAMEPAD_MAX_AXES];
+   int halfRange[GAMEPAD_MAX_AXES];
+   signed char direction[GAMEPAD_MAX_AXES];
+   // axes whose range the device reported, and axes without one that have
+   // shown they are wider than 8 bits
+   uint64_t ranged;
+   uint64_t wide;
+   uint64_t dirty;
+   unsigned long axisEvents;
+} GamepadDevice;
+
+typedef struct _GamepadAxisChange
+{
+   GamepadDevice *device;
+   int axisId;
+   // -1, 0 (inside the dead zone) or 1
+   int direction;
+} GamepadAxisChange;
+
+typedef struct _GamepadTracker
+{
+   GamepadDevice devices[GAMEPAD_MAX_DEVICES];
+   // dead zone as a percentage of the axis half range
+   int deadZone;
+   unsigned long axisEvents;
+   unsigned long axisUpdates;
+} GamepadTracker;
+
+void gamepadTrackerInit( GamepadTracker *tracker, int deadZonePercent );
+
+// Returns the slot for a new controller, or 0 if all are in use.
+GamepadDevice* gamepadTrackerConnect( GamepadTracker *tracker, void *handle );
+void gamepadTrackerDisconnect( GamepadTracker *tracker, void *handle );
+
+// Sets an axis range as reported by the device, e.g. by EVIOCGABS.
+void gamepadTrackerSetRange( GamepadDevice *device, int axisId, int min, int max );
+
+// Looks for the evdev node with this name and sets the ranges of its axes.
+// Returns false if none could be opened; its axes are then taken to be
+// 8 bit ones resting at 127 until a value outside 0..255 shows a wider,
+// signed axis resting at 0.
+bool gamepadTrackerReadRanges( GamepadDevice *device, const char *name );
+
+// Called per axis event: stores the value only.
+void gamepadTrackerAxis( GamepadDevice *device, int axisId, int value );
+
+// Called once per frame: fills in up to maxChanges direction changes and
+// returns how many there were.
+int gamepadTrackerUpdate( GamepadTracker *tracker, GamepadAxisChange *changes, int maxChanges );
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "touch-tracker.h"
+
+#include <string.h>
+#include <math.h>
+
+// a tap is a single contact lifted within TAP_MAX_MS that never moved
+// further than TOUCH_SLOP pixels; moving further starts a drag
+#define TAP_MAX_MS (250)
+#define TOUCH_SLOP (20)
+
+static TouchContact *findContact( TouchTracker *tracker, int id )
+{
+   for( int i= 0; i < TOUCH_MAX_CONTACTS; ++i )
+   {
+      if ( tracker->contacts[i].active && (tracker->contacts[i].id == id) )
+      {
+         return &tracker->contacts[i];
+      }
+   }
+   return 0;
+}
+
+// first two active contacts in slot order, which is down order for a pinch
+static int activePair( TouchTracker *tracker, TouchContact **first, TouchContact **second )
+{
+   int found= 0;
+
+   for( int i= 0; (i < TOUCH_MAX_CONTACTS) && (found < 2); ++i )
+   {
+      if ( tracker->contacts[i].active )
+      {
+         if ( found == 0 )
+            *first= &tracker->contacts[i];
+         else
+            *second= &tracker->contacts[i];
+         ++found;
+      }
+   }
+   return found;
+}
+
+static float contactDistance( const TouchContact *a, const TouchContact *b )
+{
+   float dx= (float)(a->x-b->x);
+   float dy= (float)(a->y-b->y);
+
+   return sqrtf( dx*dx+dy*dy );
+}
+
+static bool beyondSlop( const TouchContact *contact )
+{
+   int dx= contact->x-contact->startX;
+   int dy= contact->y-contact->startY;
+
+   return (dx*dx+dy*dy) > (TOUCH_SLOP*TOUCH_SLOP);
+}
+
+void touchTrackerInit( TouchTracker *tracker )
+{
+   memset( tracker, 0, sizeof(TouchTracker) );
+}
+
+void touchTrackerDown( TouchTracker *tracker, int id, int x, int y, long long timeMillis )
+{
+   TouchContact *contact= findContact( tracker, id );
+
+   if ( !contact )
+   {
+      for( int i= 0; i < TOUCH_MAX_CONTACTS; ++i )
+      {
+         if ( !tracker->contacts[i].active )
+         {
+            contact= &tracker->contacts[i];
+            break;
+         }
+      }
+      if ( !contact )
+      {
+         ++tracker->droppedContacts;
+         return;
+      }
+      ++tracker->activeCount;
+      ++tracker->sequenceContacts;
+   }
+
+   contact->id= id;
+   contact->active= true;
+   contact->x= contact->startX= x;
+   contact->y= contact->startY= y;
+   contact->downTime= timeMillis;
+   tracker->changed= true;
+}
+
+void touchTrackerUp( TouchTracker *tracker, int id, long long timeMillis )
+{
+   TouchContact *contact= findContact( tracker, id );
+
+   if ( !contact ) return;
+
+   if ( (tracker->sequenceContacts == 1) && !tracker->dragging &&
+        !beyondSlop( contact ) && (timeMillis-contact->downTime <= TAP_MAX_MS) )
+   {
+      tracker->tapPending= true;
+      tracker->tapX= contact->x;
+      tracker->tapY= contact->y;
+   }
+
+   contact->active= false;
+   --tracker->activeCount;
+   tracker->changed= true;
+
+   if ( tracker->activeCount < 2 )
+   {
+      tracker->pinching= false;
+   }
+   if ( tracker->activeCount == 0 )
+   {
+      tracker->sequenceContacts= 0;
+      tracker->dragging= false;
+   }
+}
+
+void touchTrackerMotion( TouchTracker *tracker, int id, int x, int y )
+{
+   TouchContact *contact= findContact( tracker, id );
+
+   if ( contact )
+   {
+      contact->x= x;
+      contact->y= y;
+      tracker->changed= true;
+   }
+}
+
+bool touchTrackerUpdate( TouchTracker *tracker, TouchGesture *gesture )
+{
+   TouchContact *first= 0, *second= 0;
+   int count;
+
+   if ( !tracker->changed && !tracker->tapPending ) return false;
+   tracker->changed= false;
+
+   gesture->type= TouchGesture_none;
+   gesture->scale= 1.0f;
+
+   if ( tracker->tapPending )
+   {
+      tracker->tapPending= false;
+      gesture->type= TouchGesture_tap;
+      gesture->x= tracker->tapX;
+      gesture->y= tracker->tapY;
+      return true;
+   }
+
+   count= activePair( tracker, &first, &second );
+   if ( count >= 2 )
+   {
+      float distance= contactDistance( first, second );
+
+      if ( !tracker->pinching )
+      {
+         tracker->pinching= true;
+         tracker->dragging= false;
+         tracker->pinchStartDistance= (distance > 1.0f) ? distance : 1.0f;
+      }
+      gesture->type= TouchGesture_pinch;
+      gesture->x= (first->x+second->x)/2;
+      gesture->y= (first->y+second->y)/2;
+      gesture->scale= distance/tracker->pinchStartDistance;
+      return true;
+   }
+
+   if ( (count == 1) && !tracker->pinching && (tracker->sequenceContacts == 1) )
+   {
+      if ( tracker->dragging || beyondSlop( first ) )
+      {
+         tracker->dragging= true;
+         gesture->type= TouchGesture_drag;
+         gesture->x= first->x;
+         gesture->y= first->y;
+         return true;
+      }
+   }
+
+   return false;
+}
@@ -0,0 +1,88 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2026 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _TOUCH_TRACKER_H
+#define _TOUCH_TRACKER_H
+
+/*
+ * Fixed capacity multi-touch tracking with tap/drag/pinch recognition.
+ *
+ * The down/up/motion calls only update the slot table, so any number of
+ * motion events between two frames collapse into the latest position.
+ * Gestures are evaluated once per rendered frame by touchTrackerUpdate.
+ * Nothing is allocated after touchTrackerInit.
+ */
+
+#define TOUCH_MAX_CONTACTS (10)
+
+typedef enum _TouchGestureType
+{
+   TouchGesture_none,
+   TouchGesture_tap,
+   TouchGesture_drag,
+   TouchGesture_pinch
+} TouchGestureType;
+
+typedef struct _TouchGesture
+{
+   TouchGestureType type;
+   // tap and drag: contact position; pinch: midpoint of the two contacts
+   int x;
+   int y;
+   // pinch: distance relative to when the second contact went down
+   float scale;
+} TouchGesture;
+
+typedef struct _TouchContact
+{
+   int id;
+   bool active;
+   int x;
+   int y;
+   int startX;
+   int startY;
+   long long downTime;
+} TouchContact;
+
+typedef struct _TouchTracker
+{
+   TouchContact contacts[TOUCH_MAX_CONTACTS];
+   int activeCount;
+   // contacts seen since the last time no finger was down
+   int sequenceContacts;
+   bool dragging;
+   bool pinching;
+   float pinchStartDistance;
+   // set by touchTrackerUp when a short, still contact ends a sequence
+   bool tapPending;
+   int tapX;
+   int tapY;
+   // motion/up/down since the last touchTrackerUpdate
+   bool changed;
+   unsigned long droppedContacts;
+} TouchTracker;
+
+void touchTrackerInit( TouchTracker *tracker );
+void touchTrackerDown( TouchTracker *tracker, int id, int x, int y, long long timeMillis );
+void touchTrackerUp( TouchTracker *tracker, int id, long long timeMillis );
+void touchTrackerMotion( TouchTracker *tracker, int id, int x, int y );
+
+// Evaluates the contacts once per frame, returns true if gesture was filled in.
+bool touchTrackerUpdate( TouchTracker *tracker, TouchGesture *gesture );
+
+#endif
@@ -17,43 +17,226 @@
 
 #include "egl-window.h"
 
+#include <cstdio>
+
+#include <QMutex>
 #include <QPainter>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "gpu-memory.h"
+#include "surface-format.h"
+
+static const qint64 fpsIntervalMs = 5000;
+
+static double elapsedMs(const QElapsedTimer &clock) {
+  return clock.nsecsElapsed() / 1000000.0;
+}
+
+// Owns the context in the threaded render loop. The GUI thread publishes
+// the window state with update(); when the window is unexposed it blocks
+// until the render thread has stopped using the surface.
+class EGLWindow::RenderThread : public QThread {
+ public:
+  explicit RenderThread(EGLWindow *window)
+      : window(window),
+        exposed(false),
+        rendering(false),
+        stopping(false),
+        idle(true),
+        ratio(1.0),
+        updates(0) {}
+
+  void update(const bool exposed, const bool rendering, const QSize &size,
+              const qreal ratio) {
+    QMutexLocker locker(&mutex);
+
+    this->exposed = exposed;
+    this->rendering = rendering;
+    this->size = size;
+    this->ratio = ratio;
+    ++updates;
+    condition.wakeAll();
+
+    if (!exposed)
+      while (!idle) condition.wait(&mutex);
+  }
+
+  void stop() {
+    {
+      QMutexLocker locker(&mutex);
+      stopping = true;
+      condition.wakeAll();
+    }
+    wait();
+  }
+
+ protected:
+  void run() override {
+    QMutexLocker locker(&mutex);
+
+    for (;;) {
+      while (!stopping && !(exposed && rendering)) {
+        if (!exposed && window->releaseWhenHidden && window->context) {
+          locker.unlock();
+          window->releaseResources();
+          locker.relock();
+          continue;
+        }
+        idle = true;
+        condition.wakeAll();
+        condition.wait(&mutex);
+      }
+      if (stopping) break;
+
+      idle = false;
+      window->renderSize = size;
+      window->renderRatio = ratio;
+
+      const unsigned int seen = updates;
+
+      locker.unlock();
+      const bool rendered = window->renderFrame();
+      locker.relock();
+
+      // the surface could not be made current: wait for the GUI thread to
+      // report it again instead of retrying in a busy loop
+      if (!rendered && updates == seen) exposed = false;
+    }
+
+    // the context was created on this thread, so it goes away here too
+    locker.unlock();
+    window->releaseResources();
+    locker.relock();
+
+    idle = true;
+    condition.wakeAll();
+  }
+
+ private:
+  EGLWindow *window;
+  QMutex mutex;
+  QWaitCondition condition;
+  bool exposed;
+  bool rendering;
+  bool stopping;
+  bool idle;
+  QSize size;
+  qreal ratio;
+  unsigned int updates;
+};
 
 EGLWindow::EGLWindow(QWindow *parent)
     : QWindow(parent),
       rendering(false),
+      mode(RenderMode::DirectGL),
+      loop(RenderLoop::Basic),
+      overlay(false),
+      releaseWhenHidden(true),
       color(0),
+      renderRatio(1.0),
+      fpsFrames(0),
+      fps(0.0),
+      updateRequested(-1.0),
+      lastSwap(-1.0),
+      renderThread(nullptr),
       context(nullptr),
       device(nullptr) {
   setSurfaceType(QWindow::OpenGLSurface);
+  clock.start();
+}
+
+EGLWindow::~EGLWindow() {
+  shutdown();
+
+  stats.printSummary();
 }
 
-EGLWindow::~EGLWindow() {}
+void EGLWindow::shutdown() {
+  if (renderThread) {
+    renderThread->stop();
+    delete renderThread;
+    renderThread = nullptr;
+    rendering = false;
+    return;
+  }
+
+  releaseResources();
+}
 
 // This code is based on Qt OpenGL example code which is:
 // Copyright (C) 2018 The Qt Company Ltd.
 // Licensed under the BSD-3 license.
-void EGLWindow::render(QPainter *painter) {
-  Q_UNUSED(painter);
+void EGLWindow::renderGL() {
   color = (color + 1) % 256;
   const float c = color / 255.0;
   glClearColor(0.0, c, 0.0, 1.0);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void EGLWindow::render(QPainter *painter) {
+  if (!overlay) return;
+
+  const char *name = (mode == RenderMode::DirectGL) ? "direct GL" : "QPainter";
+
+  // running means since the last FPS report
+  painter->setPen(Qt::white);
+  painter->drawText(QPointF(16, 32), QStringLiteral("%1 FPS (%2)")
+                                         .arg(fps, 0, 'f', 1)
+                                         .arg(QLatin1String(name)));
+  painter->drawText(
+      QPointF(16, 56),
+      QStringLiteral("render %1 ms  swap %2 ms  update delay %3 ms")
+          .arg(stats.recentMean(FrameStats::Render), 0, 'f', 2)
+          .arg(stats.recentMean(FrameStats::Swap), 0, 'f', 2)
+          .arg(stats.recentMean(FrameStats::UpdateDelay), 0, 'f', 2));
+  painter->drawText(
+      QPointF(16, 80),
+      QStringLiteral("interval %1 ms +- %2 ms, max %3 ms")
+          .arg(stats.recentMean(FrameStats::Interval), 0, 'f', 2)
+          .arg(stats.recentDeviation(FrameStats::Interval), 0, 'f', 2)
+          .arg(stats.recentMax(FrameStats::Interval), 0, 'f', 2));
 }
 
 void EGLWindow::initialize() {}
 
+void EGLWindow::releaseGL() {}
+
 void EGLWindow::render() {
+  if (mode == RenderMode::Painter) {
+    if (!device) device = new QOpenGLPaintDevice;
+
+    device->setSize(renderPixelSize());
+    device->setDevicePixelRatio(renderRatio);
+
+    QPainter painter(device);
+    renderGL();
+    render(&painter);
+    return;
+  }
+
+  renderGL();
+
+  if (!overlay) return;
+
+  // The paint device only needs updating when the window is resized.
+  const QSize deviceSize = renderPixelSize();
+
   if (!device) device = new QOpenGLPaintDevice;
 
-  device->setSize(size() * devicePixelRatio());
-  device->setDevicePixelRatio(devicePixelRatio());
+  if (device->size() != deviceSize) {
+    device->setSize(deviceSize);
+    device->setDevicePixelRatio(renderRatio);
+  }
 
   QPainter painter(device);
   render(&painter);
 }
 
-void EGLWindow::renderLater() { requestUpdate(); }
+void EGLWindow::renderLater() {
+  if (updateRequested < 0.0) updateRequested = elapsedMs(clock);
+  requestUpdate();
+}
 
 bool EGLWindow::event(QEvent *event) {
   switch (event->type()) {
@@ -68,36 +251,169 @@ bool EGLWindow::event(QEvent *event) {
 void EGLWindow::exposeEvent(QExposeEvent *event) {
   Q_UNUSED(event);
 
-  if (isExposed()) renderNow();
+  if (renderThread) {
+    renderThread->update(isExposed(), rendering, size(), devicePixelRatio());
+    if (isExposed() && !renderThread->isRunning()) renderThread->start();
+    return;
+  }
+
+  if (isExposed())
+    renderNow();
+  else if (releaseWhenHidden)
+    releaseResources();
+}
+
+void EGLWindow::resizeEvent(QResizeEvent *event) {
+  Q_UNUSED(event);
+
+  if (renderThread)
+    renderThread->update(isExposed(), rendering, size(), devicePixelRatio());
 }
 
 void EGLWindow::renderNow() {
-  if (!isExposed()) return;
+  if (!isExposed() || renderThread) return;
+
+  renderSize = size();
+  renderRatio = devicePixelRatio();
+
+  if (updateRequested >= 0.0) {
+    stats.add(FrameStats::UpdateDelay, elapsedMs(clock) - updateRequested);
+    updateRequested = -1.0;
+  }
+
+  // the surface could not be made current: the next expose tries again,
+  // re-arming here would recreate the context on every update
+  if (!renderFrame()) return;
+
+  if (rendering) renderLater();
+}
 
+bool EGLWindow::renderFrame() {
   bool needsInitialize = false;
 
+  // a lost context (GPU reset, driver restart) is recreated from scratch
+  if (context && !context->isValid()) releaseResources();
+
   if (!context) {
-    context = new QOpenGLContext(this);
+    // a parent would have to live on the render thread
+    context = new QOpenGLContext(renderThread ? nullptr : this);
     context->setFormat(requestedFormat());
     context->create();
 
     needsInitialize = true;
   }
 
-  context->makeCurrent(this);
+  if (!context->makeCurrent(this)) {
+    releaseResources();
+    return false;
+  }
 
   if (needsInitialize) {
     initializeOpenGLFunctions();
+
+    const QString config = describeCurrentEglConfig();
+    printf("surface: requested %s, EGL %s\n",
+           qPrintable(describeSurfaceFormat(requestedFormat())),
+           config.isEmpty() ? "not in use" : qPrintable(config));
+
     initialize();
+
+    printf("surface: GL resources created, GPU memory %s\n",
+           qPrintable(describeGpuMemory()));
   }
 
+  const double renderStart = elapsedMs(clock);
+
   render();
 
+  const double swapStart = elapsedMs(clock);
+
   context->swapBuffers(this);
 
-  if (rendering) renderLater();
+  const double swapEnd = elapsedMs(clock);
+
+  stats.add(FrameStats::Render, swapStart - renderStart);
+  stats.add(FrameStats::Swap, swapEnd - swapStart);
+  if (lastSwap >= 0.0) stats.add(FrameStats::Interval, swapEnd - lastSwap);
+  lastSwap = swapEnd;
+
+  showFps();
+
+  emit frameSwapped();
+  return true;
+}
+
+// Runs on the thread that owns the context.
+void EGLWindow::releaseResources() {
+  if (!context) return;
+
+  const bool current = context->makeCurrent(this);
+
+  releaseGL();
+
+  delete device;
+  device = nullptr;
+
+  if (current) context->doneCurrent();
+  delete context;
+  context = nullptr;
+
+  lastSwap = -1.0;
+
+  printf("surface: GL resources released, GPU memory %s\n",
+         qPrintable(describeGpuMemory()));
+  fflush(stdout);
+}
+
+void EGLWindow::showFps() {
+  if (!fpsTimer.isValid()) {
+    fpsTimer.start();
+    stats.resetRecent();
+    return;
+  }
+
+  ++fpsFrames;
+
+  const qint64 elapsed = fpsTimer.elapsed();
+
+  if (elapsed < fpsIntervalMs) return;
+
+  fps = fpsFrames * 1000.0 / elapsed;
+  printf("FPS: %f (%s, %s loop%s), frame %.2f ms +- %.2f ms, max %.2f ms\n",
+         fps, (mode == RenderMode::DirectGL) ? "direct GL" : "QPainter",
+         (loop == RenderLoop::Threaded) ? "threaded" : "basic",
+         overlay ? ", overlay" : "", stats.recentMean(FrameStats::Interval),
+         stats.recentDeviation(FrameStats::Interval),
+         stats.recentMax(FrameStats::Interval));
+  fflush(stdout);
+
+  fpsFrames = 0;
+  fpsTimer.restart();
+  stats.resetRecent();
 }
 
 void EGLWindow::setRendering(const bool rendering) {
-  if ((this->rendering = rendering)) renderLater();
+  this->rendering = rendering;
+
+  if (renderThread)
+    renderThread->update(isExposed(), rendering, size(), devicePixelRatio());
+  else if (rendering)
+    renderLater();
+}
+
+void EGLWindow::setRenderMode(const RenderMode mode) {
+  this->mode = mode;
+  fpsFrames = 0;
+  fpsTimer.invalidate();
 }
+
+void EGLWindow::setRenderLoop(const RenderLoop loop) {
+  if (context) return;
+
+  this->loop = loop;
+
+  if (loop == RenderLoop::Threaded && !renderThread)
+    renderThread = new RenderThread(this);
+}
+
+void EGLWindow::setOverlay(const bool overlay) { this->overlay = overlay; }
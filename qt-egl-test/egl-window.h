@@ -17,23 +17,62 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QOpenGLExtraFunctions>
 #include <QOpenGLPaintDevice>
 #include <QOpenGLWindow>
 
+#include "frame-stats.h"
+
 class EGLWindow : public QWindow, protected QOpenGLFunctions {
   Q_OBJECT
  public:
+  // DirectGL issues the GL content straight to the context and only
+  // engages QPainter when an overlay is enabled. Painter wraps every frame
+  // in a QPainter on a QOpenGLPaintDevice, as this sample originally did.
+  enum class RenderMode { DirectGL, Painter };
+
+  // Basic renders on the GUI thread, paced by requestUpdate(). Threaded
+  // moves the context to a dedicated render thread that renders back to
+  // back and only synchronizes with the GUI thread on expose and resize,
+  // like the Qt Quick threaded render loop.
+  enum class RenderLoop { Basic, Threaded };
+
   explicit EGLWindow(QWindow *parent = nullptr);
   ~EGLWindow();
 
+  virtual void renderGL();
   virtual void render(QPainter *painter);
   virtual void render();
 
   virtual void initialize();
 
+  // Counterpart of initialize(): frees the subclass's GL objects before
+  // the context is destroyed, with the context current when that is still
+  // possible (it is not after a context loss or once the surface is gone).
+  virtual void releaseGL();
+
   void setRendering(const bool rendering);
 
+  void setRenderMode(const RenderMode mode);
+  RenderMode renderMode() const { return mode; }
+
+  void setOverlay(const bool overlay);
+
+  // Must be set before the window is first shown.
+  void setRenderLoop(const RenderLoop loop);
+  RenderLoop renderLoop() const { return loop; }
+
+  // By default the context, the paint device and everything allocated in
+  // initialize() are released when the window is unexposed and recreated
+  // on the next expose, so a hidden app gives its GPU memory back.
+  void setReleaseWhenHidden(const bool release) { releaseWhenHidden = release; }
+
+ signals:
+  // Emitted after every swap on the thread that renders, with the
+  // window's context still current there.
+  void frameSwapped();
+
  public slots:
   void renderLater();
   void renderNow();
@@ -42,11 +81,49 @@ class EGLWindow : public QWindow, protected QOpenGLFunctions {
   bool event(QEvent *event) override;
 
   void exposeEvent(QExposeEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+
+  // Size of the frame being rendered in pixels, for the render hooks.
+  QSize renderPixelSize() const { return renderSize * renderRatio; }
+
+  // Stops rendering and releases the GL resources. Subclasses that
+  // implement releaseGL() call it from their destructor, while their part
+  // of the object still exists; it is a no-op the second time.
+  void shutdown();
 
  private:
+  class RenderThread;
+
+  // Returns false when the surface could not be made current.
+  bool renderFrame();
+  void releaseResources();
+  void showFps();
+
   bool rendering;
+  RenderMode mode;
+  RenderLoop loop;
+  bool overlay;
+  bool releaseWhenHidden;
   int color;
 
+  // Size as seen by the rendering thread, updated under synchronization
+  // when the render thread is used.
+  QSize renderSize;
+  qreal renderRatio;
+
+  QElapsedTimer fpsTimer;
+  int fpsFrames;
+  double fps;
+
+  // Timestamps in ms on clock, updateRequested is negative when no
+  // UpdateRequest is pending.
+  QElapsedTimer clock;
+  double updateRequested;
+  double lastSwap;
+  FrameStats stats;
+
+  RenderThread *renderThread;
+
   QOpenGLContext *context;
   QOpenGLPaintDevice *device;
 };
@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "frame-stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static const char *metricNames[FrameStats::MetricCount] = {
+    "update delay", "render", "swap", "interval"};
+
+FrameStats::FrameStats() {
+  for (Series &s : series) {
+    s.samples.reserve(maxSamples);
+    s.next = 0;
+    s.total = 0;
+  }
+  resetRecent();
+}
+
+void FrameStats::add(const Metric metric, const double ms) {
+  Series &s = series[metric];
+
+  if (static_cast<int>(s.samples.size()) < maxSamples) {
+    s.samples.push_back(ms);
+  } else {
+    s.samples[s.next] = ms;
+    s.next = (s.next + 1) % maxSamples;
+  }
+  ++s.total;
+
+  ++s.count;
+  s.sum += ms;
+  s.squares += ms * ms;
+  s.max = std::max(s.max, ms);
+}
+
+int FrameStats::recentCount(const Metric metric) const {
+  return series[metric].count;
+}
+
+double FrameStats::recentMean(const Metric metric) const {
+  const Series &s = series[metric];
+
+  return s.count ? s.sum / s.count : 0.0;
+}
+
+double FrameStats::recentDeviation(const Metric metric) const {
+  const Series &s = series[metric];
+
+  if (!s.count) return 0.0;
+
+  const double mean = s.sum / s.count;
+
+  return std::sqrt(std::max(s.squares / s.count - mean * mean, 0.0));
+}
+
+double FrameStats::recentMax(const Metric metric) const {
+  return series[metric].max;
+}
+
+void FrameStats::resetRecent() {
+  for (Series &s : series) {
+    s.count = 0;
+    s.sum = 0.0;
+    s.squares = 0.0;
+    s.max = 0.0;
+  }
+}
+
+void FrameStats::printSummary() const {
+  printf("frame statistics (ms):\n");
+  printf("  %-14s %8s %8s %8s %8s %8s %8s\n", "", "frames", "mean", "p50",
+         "p90", "p99", "max");
+
+  for (int metric = 0; metric < MetricCount; ++metric) {
+    const Series &s = series[metric];
+
+    if (s.samples.empty()) continue;
+
+    std::vector<float> sorted(s.samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (const float ms : sorted) sum += ms;
+
+    const size_t last = sorted.size() - 1;
+
+    printf("  %-14s %8lu %8.2f %8.2f %8.2f %8.2f %8.2f\n", metricNames[metric],
+           s.total, sum / sorted.size(), sorted[last * 50 / 100],
+           sorted[last * 90 / 100], sorted[last * 99 / 100], sorted[last]);
+  }
+  fflush(stdout);
+}
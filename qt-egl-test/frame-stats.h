@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <vector>
+
+// Per-frame timings in milliseconds. Every sample goes into a
+// preallocated ring (the most recent maxSamples are kept for the
+// percentiles printed by printSummary()) and into a running window that
+// the periodic report reads and resets.
+class FrameStats {
+ public:
+  enum Metric {
+    UpdateDelay,  // requestUpdate() to the start of rendering
+    Render,       // CPU time spent issuing the frame
+    Swap,         // time spent in swapBuffers()
+    Interval,     // swap to swap
+    MetricCount
+  };
+
+  FrameStats();
+
+  void add(const Metric metric, const double ms);
+
+  int recentCount(const Metric metric) const;
+  double recentMean(const Metric metric) const;
+  double recentDeviation(const Metric metric) const;
+  double recentMax(const Metric metric) const;
+  void resetRecent();
+
+  // Mean, p50, p90, p99 and max of each metric.
+  void printSummary() const;
+
+ private:
+  static const int maxSamples = 65536;
+
+  struct Series {
+    std::vector<float> samples;
+    int next;
+    unsigned long total;
+    int count;
+    double sum;
+    double squares;
+    double max;
+  };
+
+  Series series[MetricCount];
+};
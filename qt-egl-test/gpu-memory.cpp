@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "gpu-memory.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QStringList>
+
+// GL_NVX_gpu_memory_info
+static const GLenum totalAvailableMemoryNvx = 0x9048;
+static const GLenum currentAvailableVidmemNvx = 0x9049;
+// GL_ATI_meminfo
+static const GLenum textureFreeMemoryAti = 0x87FC;
+
+// Sums drm-resident-<region> (or drm-memory-<region> on older kernels)
+// over the DRM files of this process in KiB, counting each drm-client-id
+// once since several descriptors can share a client. -1 when there are
+// none.
+static long drmClientMemoryKb() {
+  DIR *dir = opendir("/proc/self/fdinfo");
+  std::vector<unsigned long long> clients;
+  long totalKb = -1;
+
+  if (!dir) return -1;
+
+  while (const struct dirent *entry = readdir(dir)) {
+    char path[64];
+    char line[256];
+    unsigned long long client = 0;
+    bool drm = false;
+    long residentKb = 0;
+    long memoryKb = 0;
+
+    if (entry->d_name[0] == '.') continue;
+
+    snprintf(path, sizeof(path), "/proc/self/fdinfo/%s", entry->d_name);
+
+    FILE *info = fopen(path, "r");
+    if (!info) continue;
+
+    while (fgets(line, sizeof(line), info)) {
+      char key[128];
+      char unit[16] = "";
+      unsigned long long value;
+
+      if (sscanf(line, "%127[^:]: %llu %15s", key, &value, unit) < 2) continue;
+
+      if (!strcmp(key, "drm-client-id")) {
+        client = value;
+        drm = true;
+        continue;
+      }
+
+      const long kb = !strcmp(unit, "MiB")   ? value * 1024
+                      : !strcmp(unit, "KiB") ? value
+                                             : value / 1024;
+
+      if (!strncmp(key, "drm-resident-", 13))
+        residentKb += kb;
+      else if (!strncmp(key, "drm-memory-", 11))
+        memoryKb += kb;
+    }
+    fclose(info);
+
+    if (!drm ||
+        std::find(clients.begin(), clients.end(), client) != clients.end())
+      continue;
+
+    clients.push_back(client);
+    totalKb = std::max(totalKb, 0L) + (residentKb ? residentKb : memoryKb);
+  }
+  closedir(dir);
+
+  return totalKb;
+}
+
+QString describeGpuMemory() {
+  QOpenGLContext *context = QOpenGLContext::currentContext();
+  QStringList parts;
+
+  if (context) {
+    QOpenGLFunctions *gl = context->functions();
+
+    if (context->hasExtension("GL_NVX_gpu_memory_info")) {
+      GLint totalKb = 0;
+      GLint availableKb = 0;
+
+      gl->glGetIntegerv(totalAvailableMemoryNvx, &totalKb);
+      gl->glGetIntegerv(currentAvailableVidmemNvx, &availableKb);
+      parts << QStringLiteral("%1 of %2 MB in use (NVX)")
+                   .arg((totalKb - availableKb) / 1024)
+                   .arg(totalKb / 1024);
+    } else if (context->hasExtension("GL_ATI_meminfo")) {
+      GLint textureKb[4] = {0, 0, 0, 0};
+
+      gl->glGetIntegerv(textureFreeMemoryAti, textureKb);
+      parts << QStringLiteral("%1 MB free for textures (ATI)")
+                   .arg(textureKb[0] / 1024);
+    }
+  }
+
+  const long drmKb = drmClientMemoryKb();
+
+  if (drmKb >= 0)
+    parts << QStringLiteral("%1 MB resident (fdinfo)")
+                 .arg(drmKb / 1024.0, 0, 'f', 1);
+
+  return parts.isEmpty() ? QStringLiteral("unknown")
+                         : parts.join(QStringLiteral(", "));
+}
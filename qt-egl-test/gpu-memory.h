@@ -0,0 +1,26 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <QString>
+
+// GPU memory as far as it can be found out: GL_NVX_gpu_memory_info or
+// GL_ATI_meminfo when a context is current, and the per-client totals the
+// DRM driver publishes in /proc/self/fdinfo, which also works without a
+// context. "unknown" when none of these is available.
+QString describeGpuMemory();
@@ -15,20 +15,78 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <csignal>
+
+#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QSurfaceFormat>
+#include <QTimer>
 
 #include "egl-window.h"
+#include "surface-format.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void signalHandler(int signum) {
+  Q_UNUSED(signum);
+  stopRequested = 1;
+}
 
 int main(int argc, char *argv[]) {
   QGuiApplication app(argc, argv);
 
-  QSurfaceFormat format;
-  format.setSamples(24);
-  format.setRenderableType(QSurfaceFormat::OpenGLES);
+  // Leave the event loop on SIGINT/SIGTERM so the window is destroyed
+  // and prints its frame statistics.
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  QTimer stopPoll;
+  QObject::connect(&stopPoll, &QTimer::timeout, []() {
+    if (stopRequested) QCoreApplication::quit();
+  });
+  stopPoll.start(100);
+
+  // RENDER_MODE=gl|painter, OVERLAY=1 draws the FPS with QPainter on top
+  const EGLWindow::RenderMode mode = (qgetenv("RENDER_MODE") == "painter")
+                                         ? EGLWindow::RenderMode::Painter
+                                         : EGLWindow::RenderMode::DirectGL;
+  const bool overlay = (qgetenv("OVERLAY") == "1");
+
+  // FORMAT_SWEEP=<frames> renders that many frames per surface format
+  if (qEnvironmentVariableIntValue("FORMAT_SWEEP") > 0) {
+    SurfaceFormatSweep sweep(qEnvironmentVariableIntValue("FORMAT_SWEEP"),
+                             mode, overlay);
+    sweep.start();
+    return app.exec();
+  }
 
   EGLWindow window;
-  window.setFormat(format);
+  window.setFormat(surfaceFormatFromEnvironment());
+  window.setRenderMode(mode);
+  window.setOverlay(overlay);
+
+  // KEEP_GL_RESOURCES=1 holds on to the context while hidden
+  window.setReleaseWhenHidden(qgetenv("KEEP_GL_RESOURCES") != "1");
+
+  // RENDER_LOOP=basic|threaded
+  if (qgetenv("RENDER_LOOP") == "threaded")
+    window.setRenderLoop(EGLWindow::RenderLoop::Threaded);
+
+  // GUI_LOAD=<ms> keeps the GUI thread busy for that long every 16 ms,
+  // standing in for application work competing with rendering
+  const int guiLoadMs = qEnvironmentVariableIntValue("GUI_LOAD");
+  QTimer guiLoad;
+
+  if (guiLoadMs > 0) {
+    QObject::connect(&guiLoad, &QTimer::timeout, [guiLoadMs]() {
+      QElapsedTimer busy;
+      busy.start();
+      while (busy.elapsed() < guiLoadMs) {
+      }
+    });
+    guiLoad.start(16);
+  }
+
   window.showFullScreen();
   window.setRendering(true);
 
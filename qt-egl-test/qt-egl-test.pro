@@ -17,9 +17,12 @@
 
 QT += opengl
 
-HEADERS = egl-window.h
+HEADERS = egl-window.h frame-stats.h gpu-memory.h surface-format.h
 
-SOURCES = main.cpp egl-window.cpp
+SOURCES = main.cpp egl-window.cpp frame-stats.cpp gpu-memory.cpp \
+          surface-format.cpp
+
+LIBS += -lEGL
 
 TARGET = qt-egl-test
 TEMPLATE = app
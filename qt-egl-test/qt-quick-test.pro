@@ -0,0 +1,34 @@
+#
+# Copyright (C) 2026  RDK Management
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+
+QT += opengl quick
+
+HEADERS = egl-window.h frame-stats.h gpu-memory.h scene-window.h surface-format.h
+
+SOURCES = quick-main.cpp egl-window.cpp frame-stats.cpp gpu-memory.cpp \
+          scene-window.cpp surface-format.cpp
+
+RESOURCES = scene.qrc
+
+LIBS += -lEGL
+
+TARGET = qt-quick-test
+TEMPLATE = app
+
+target.path=$$PREFIX/usr/bin
+
+INSTALLS += target
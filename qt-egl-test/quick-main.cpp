@@ -0,0 +1,190 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// Renders the same animated scene through Qt Quick (SCENE=quick, the
+// default) or through EGLWindow with plain GL (SCENE=egl) and reports
+// frame statistics and memory use, to see how the scene graph's batching
+// scales with ITEMS (default 300). Runs FRAMES frames (default 600).
+// Headless with Mesa:
+//
+//   QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 ./qt-quick-test
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickImageProvider>
+#include <QQuickView>
+#include <QTimer>
+
+#include "frame-stats.h"
+#include "scene-window.h"
+#include "surface-format.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void signalHandler(int signum) {
+  Q_UNUSED(signum);
+  stopRequested = 1;
+}
+
+class TileProvider : public QQuickImageProvider {
+ public:
+  TileProvider() : QQuickImageProvider(QQuickImageProvider::Image) {}
+
+  QImage requestImage(const QString &id, QSize *size,
+                      const QSize &requestedSize) override {
+    Q_UNUSED(id);
+    Q_UNUSED(requestedSize);
+
+    const QImage image = sceneTileImage();
+
+    if (size) *size = image.size();
+
+    return image;
+  }
+};
+
+static void showMemory() {
+  FILE *status = fopen("/proc/self/status", "r");
+  char line[256];
+  long rssKb = 0;
+  long peakKb = 0;
+
+  if (!status) return;
+
+  while (fgets(line, sizeof(line), status)) {
+    if (!strncmp(line, "VmRSS:", 6)) rssKb = atol(line + 6);
+    if (!strncmp(line, "VmHWM:", 6)) peakKb = atol(line + 6);
+  }
+  fclose(status);
+
+  printf("memory: RSS %.1f MB, peak %.1f MB\n", rssKb / 1024.0,
+         peakKb / 1024.0);
+}
+
+static double elapsedMs(const QElapsedTimer &clock) {
+  return clock.nsecsElapsed() / 1000000.0;
+}
+
+// The scene graph renders and swaps on its own render thread when the
+// threaded loop is in use, so the timing hooks use direct connections
+// and only touch the stats from there.
+static void runQuick(QGuiApplication *app, const int items, const int frames) {
+  QQuickView *view = new QQuickView;
+  FrameStats stats;
+  QElapsedTimer clock;
+  double renderStart = 0.0;
+  double swapStart = 0.0;
+  double lastSwap = -1.0;
+  int frameCount = 0;
+
+  view->setFormat(surfaceFormatFromEnvironment());
+  view->engine()->addImageProvider(QStringLiteral("scene"), new TileProvider);
+  view->rootContext()->setContextProperty(QStringLiteral("itemCount"), items);
+  view->setResizeMode(QQuickView::SizeRootObjectToView);
+  view->setSource(QUrl(QStringLiteral("qrc:/scene.qml")));
+
+  QObject::connect(view, &QQuickWindow::beforeRendering, view,
+                   [&]() { renderStart = elapsedMs(clock); },
+                   Qt::DirectConnection);
+  QObject::connect(view, &QQuickWindow::afterRendering, view,
+                   [&]() {
+                     swapStart = elapsedMs(clock);
+                     stats.add(FrameStats::Render, swapStart - renderStart);
+                   },
+                   Qt::DirectConnection);
+  QObject::connect(view, &QQuickWindow::frameSwapped, view,
+                   [&]() {
+                     const double now = elapsedMs(clock);
+
+                     stats.add(FrameStats::Swap, now - swapStart);
+                     if (lastSwap >= 0.0)
+                       stats.add(FrameStats::Interval, now - lastSwap);
+                     lastSwap = now;
+
+                     if (++frameCount == frames)
+                       QMetaObject::invokeMethod(app, "quit",
+                                                 Qt::QueuedConnection);
+                   },
+                   Qt::DirectConnection);
+
+  clock.start();
+  view->showFullScreen();
+  app->exec();
+
+  showMemory();
+  delete view;
+  stats.printSummary();
+}
+
+static void runEgl(QGuiApplication *app, const int items, const int frames) {
+  SceneWindow window(items);
+  int frameCount = 0;
+
+  window.setFormat(surfaceFormatFromEnvironment());
+  if (qgetenv("RENDER_LOOP") == "threaded")
+    window.setRenderLoop(EGLWindow::RenderLoop::Threaded);
+
+  QObject::connect(&window, &EGLWindow::frameSwapped, app, [&]() {
+    if (++frameCount == frames) QCoreApplication::quit();
+  });
+
+  window.showFullScreen();
+  window.setRendering(true);
+  app->exec();
+
+  showMemory();
+}
+
+int main(int argc, char *argv[]) {
+  QGuiApplication app(argc, argv);
+
+  signal(SIGINT, signalHandler);
+  signal(SIGTERM, signalHandler);
+
+  QTimer stopPoll;
+  QObject::connect(&stopPoll, &QTimer::timeout, []() {
+    if (stopRequested) QCoreApplication::quit();
+  });
+  stopPoll.start(100);
+
+  const bool quick = (qgetenv("SCENE") != "egl");
+  const int items = qEnvironmentVariableIsSet("ITEMS")
+                        ? std::max(qEnvironmentVariableIntValue("ITEMS"), 1)
+                        : 300;
+  const int frames = qEnvironmentVariableIsSet("FRAMES")
+                         ? qEnvironmentVariableIntValue("FRAMES")
+                         : 600;
+
+  printf("scene: %s, %d items, %d frames\n", quick ? "Qt Quick" : "EGLWindow",
+         items, frames);
+  fflush(stdout);
+
+  if (quick)
+    runQuick(&app, items, frames);
+  else
+    runEgl(&app, items, frames);
+
+  return 0;
+}
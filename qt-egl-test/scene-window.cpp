@@ -0,0 +1,209 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "scene-window.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QColor>
+#include <QFont>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QVector2D>
+
+static const qint64 periodMs = 2000;
+
+static const GLfloat unitQuad[4][2] = {
+    {-0.5f, -0.5f}, {0.5f, -0.5f}, {-0.5f, 0.5f}, {0.5f, 0.5f}};
+
+static const char *vertexSource =
+    "attribute vec2 position;\n"
+    "uniform vec2 viewport;\n"
+    "uniform vec2 center;\n"
+    "uniform vec2 size;\n"
+    "uniform float angle;\n"
+    "varying vec2 uv;\n"
+    "void main() {\n"
+    "  float c = cos(angle);\n"
+    "  float s = sin(angle);\n"
+    "  vec2 p = position * size;\n"
+    "  p = vec2(p.x * c - p.y * s, p.x * s + p.y * c) + center;\n"
+    "  gl_Position = vec4(p.x / viewport.x * 2.0 - 1.0,\n"
+    "                     1.0 - p.y / viewport.y * 2.0, 0.0, 1.0);\n"
+    "  uv = position + 0.5;\n"
+    "}\n";
+
+static const char *fragmentSource =
+    "precision mediump float;\n"
+    "uniform sampler2D image;\n"
+    "uniform vec4 color;\n"
+    "uniform float textured;\n"
+    "varying vec2 uv;\n"
+    "void main() {\n"
+    "  gl_FragColor = mix(color, texture2D(image, uv), textured);\n"
+    "}\n";
+
+QImage sceneTileImage() {
+  QImage image(64, 64, QImage::Format_RGBA8888_Premultiplied);
+
+  for (int y = 0; y < image.height(); ++y)
+    for (int x = 0; x < image.width(); ++x) {
+      const int shade = 128 + x * 2;
+      image.setPixelColor(x, y, ((x / 8 + y / 8) % 2)
+                                    ? QColor(shade, 96, 32)
+                                    : QColor(32, 96, shade));
+    }
+
+  return image;
+}
+
+QImage sceneLabelImage(const int index) {
+  QImage image(128, 32, QImage::Format_RGBA8888_Premultiplied);
+  QFont font;
+
+  image.fill(Qt::transparent);
+  font.setPixelSize(24);
+
+  QPainter painter(&image);
+  painter.setFont(font);
+  painter.setPen(Qt::white);
+  painter.drawText(image.rect(), Qt::AlignCenter,
+                   QStringLiteral("Item %1").arg(index));
+
+  return image;
+}
+
+SceneWindow::SceneWindow(const int count, QWindow *parent)
+    : EGLWindow(parent), count(count), program(nullptr), tile(0) {}
+
+SceneWindow::~SceneWindow() { shutdown(); }
+
+GLuint SceneWindow::uploadImage(const QImage &image) {
+  const QImage rgba =
+      image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+  GLuint texture;
+
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, rgba.width(), rgba.height(), 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, rgba.constBits());
+
+  return texture;
+}
+
+void SceneWindow::initialize() {
+  program = new QOpenGLShaderProgram;
+  program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource);
+  program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource);
+  program->bindAttributeLocation("position", 0);
+  program->link();
+
+  tile = uploadImage(sceneTileImage());
+  for (int i = 2; i < count; i += 3)
+    labels.push_back(uploadImage(sceneLabelImage(i)));
+
+  clock.start();
+}
+
+void SceneWindow::releaseGL() {
+  // without a current context the objects are already gone with it
+  if (QOpenGLContext::currentContext()) {
+    glDeleteTextures(labels.size(), labels.data());
+    glDeleteTextures(1, &tile);
+  }
+
+  delete program;
+  program = nullptr;
+  labels.clear();
+  tile = 0;
+}
+
+void SceneWindow::renderGL() {
+  const QSize pixels = renderPixelSize();
+  const int columns = std::ceil(std::sqrt(static_cast<double>(count)));
+  const int rows = (count + columns - 1) / columns;
+  const float cell = std::min(pixels.width() / static_cast<float>(columns),
+                              pixels.height() / static_cast<float>(rows));
+  const float itemSize = cell * 0.8f;
+  const float t = (clock.elapsed() % periodMs) / static_cast<float>(periodMs);
+  const float angle = t * 2.0f * M_PI;
+
+  glViewport(0, 0, pixels.width(), pixels.height());
+  glClearColor(0.0, 0.0, 0.0, 1.0);
+  glClear(GL_COLOR_BUFFER_BIT);
+
+  // an overlay painted with QPainter may have changed any of this state
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  glActiveTexture(GL_TEXTURE0);
+
+  program->bind();
+  program->setUniformValue("viewport",
+                           QVector2D(pixels.width(), pixels.height()));
+  program->setUniformValue("angle", angle);
+
+  const int centerLocation = program->uniformLocation("center");
+  const int sizeLocation = program->uniformLocation("size");
+  const int colorLocation = program->uniformLocation("color");
+  const int texturedLocation = program->uniformLocation("textured");
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, unitQuad);
+  glEnableVertexAttribArray(0);
+
+  for (int i = 0; i < count; ++i) {
+    const float x =
+        (i % columns + 0.5f) * cell +
+        std::sin((t + i / static_cast<float>(count)) * 2.0f * M_PI) * cell *
+            0.1f;
+    const float y = (i / columns + 0.5f) * cell;
+
+    program->setUniformValue(centerLocation, QVector2D(x, y));
+
+    switch (i % 3) {
+      case 0:
+        program->setUniformValue(
+            colorLocation, QColor::fromHslF(i / static_cast<float>(count),
+                                            0.8, 0.5));
+        program->setUniformValue(texturedLocation, 0.0f);
+        program->setUniformValue(sizeLocation, QVector2D(itemSize, itemSize));
+        break;
+      case 1:
+        glBindTexture(GL_TEXTURE_2D, tile);
+        program->setUniformValue(texturedLocation, 1.0f);
+        program->setUniformValue(sizeLocation, QVector2D(itemSize, itemSize));
+        break;
+      default:
+        glBindTexture(GL_TEXTURE_2D, labels[i / 3]);
+        program->setUniformValue(texturedLocation, 1.0f);
+        program->setUniformValue(sizeLocation,
+                                 QVector2D(itemSize, itemSize / 4));
+        break;
+    }
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  }
+
+  glDisableVertexAttribArray(0);
+  glDisable(GL_BLEND);
+  program->release();
+}
@@ -0,0 +1,56 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QOpenGLShaderProgram>
+
+#include "egl-window.h"
+
+// The benchmark scene shared with scene.qml: items on a grid, every
+// third one a rectangle, an image or a text label, all moving and
+// rotating with a 2 second period. Item i sits in cell i of a grid with
+// ceil(sqrt(count)) columns.
+QImage sceneTileImage();
+QImage sceneLabelImage(const int index);
+
+// The scene drawn with plain GL on EGLWindow, one draw call per item and
+// one texture per label, the way a hand written renderer would do it.
+class SceneWindow : public EGLWindow {
+  Q_OBJECT
+ public:
+  explicit SceneWindow(const int count, QWindow *parent = nullptr);
+  ~SceneWindow();
+
+  void initialize() override;
+  void releaseGL() override;
+  void renderGL() override;
+
+ private:
+  GLuint uploadImage(const QImage &image);
+
+  int count;
+  QElapsedTimer clock;
+
+  QOpenGLShaderProgram *program;
+  GLuint tile;
+  std::vector<GLuint> labels;
+};
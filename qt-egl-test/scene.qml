@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// The benchmark scene of SceneWindow (scene-window.cpp) as Qt Quick
+// items; itemCount is set by qt-quick-test.
+
+import QtQuick 2.6
+
+Rectangle {
+    id: root
+
+    property real t: 0
+    readonly property int columns: Math.ceil(Math.sqrt(itemCount))
+    readonly property int rows: Math.ceil(itemCount / columns)
+    readonly property real cell: Math.min(width / columns, height / rows)
+    readonly property real itemSize: cell * 0.8
+
+    function centerX(item) {
+        return (item % columns + 0.5) * cell
+                + Math.sin((t + item / itemCount) * 2 * Math.PI) * cell * 0.1
+    }
+
+    function centerY(item) {
+        return (Math.floor(item / columns) + 0.5) * cell
+    }
+
+    color: "black"
+
+    NumberAnimation on t {
+        from: 0
+        to: 1
+        duration: 2000
+        loops: Animation.Infinite
+    }
+
+    Repeater {
+        model: Math.ceil(itemCount / 3)
+
+        Rectangle {
+            readonly property int item: index * 3
+
+            x: root.centerX(item) - width / 2
+            y: root.centerY(item) - height / 2
+            width: root.itemSize
+            height: root.itemSize
+            rotation: root.t * 360
+            color: Qt.hsla(item / itemCount, 0.8, 0.5, 1)
+        }
+    }
+
+    Repeater {
+        model: Math.max(Math.ceil((itemCount - 1) / 3), 0)
+
+        Image {
+            readonly property int item: index * 3 + 1
+
+            x: root.centerX(item) - width / 2
+            y: root.centerY(item) - height / 2
+            width: root.itemSize
+            height: root.itemSize
+            rotation: root.t * 360
+            source: "image://scene/tile"
+        }
+    }
+
+    Repeater {
+        model: Math.max(Math.ceil((itemCount - 2) / 3), 0)
+
+        Text {
+            readonly property int item: index * 3 + 2
+
+            x: root.centerX(item) - width / 2
+            y: root.centerY(item) - height / 2
+            width: root.itemSize
+            height: root.itemSize / 4
+            rotation: root.t * 360
+            horizontalAlignment: Text.AlignHCenter
+            verticalAlignment: Text.AlignVCenter
+            font.pixelSize: Math.max(height * 0.75, 1)
+            color: "white"
+            text: "Item " + item
+        }
+    }
+}
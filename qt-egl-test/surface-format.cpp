@@ -0,0 +1,295 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "surface-format.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <QGuiApplication>
+#include <QTimer>
+
+// Keep the EGL headers from pulling in X11, whose macros clash with Qt.
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+
+// Frames rendered before measuring, to skip context and shader setup.
+static const int warmupFrames = 10;
+
+static const char *swapBehaviorName(const QSurfaceFormat::SwapBehavior swap) {
+  switch (swap) {
+    case QSurfaceFormat::SingleBuffer:
+      return "single";
+    case QSurfaceFormat::DoubleBuffer:
+      return "double";
+    case QSurfaceFormat::TripleBuffer:
+      return "triple";
+    default:
+      return "default";
+  }
+}
+
+static int swapBehaviorFromName(const QByteArray &name) {
+  if (name == "single") return QSurfaceFormat::SingleBuffer;
+  if (name == "double") return QSurfaceFormat::DoubleBuffer;
+  if (name == "triple") return QSurfaceFormat::TripleBuffer;
+  return QSurfaceFormat::DefaultSwapBehavior;
+}
+
+static void setColorDepth(QSurfaceFormat *format, const int depth) {
+  switch (depth) {
+    case 16:
+      format->setRedBufferSize(5);
+      format->setGreenBufferSize(6);
+      format->setBlueBufferSize(5);
+      format->setAlphaBufferSize(0);
+      break;
+    case 24:
+      format->setRedBufferSize(8);
+      format->setGreenBufferSize(8);
+      format->setBlueBufferSize(8);
+      format->setAlphaBufferSize(0);
+      break;
+    case 32:
+      format->setRedBufferSize(8);
+      format->setGreenBufferSize(8);
+      format->setBlueBufferSize(8);
+      format->setAlphaBufferSize(8);
+      break;
+    default:
+      break;
+  }
+}
+
+// The single pinned value when the variable is set, the defaults otherwise.
+static QList<int> sweepValues(const char *name, const QList<int> &defaults) {
+  const QByteArray value = qgetenv(name);
+
+  if (value.isEmpty()) return defaults;
+  if (!qstrcmp(name, "SWAP_BEHAVIOR"))
+    return QList<int>() << swapBehaviorFromName(value);
+  return QList<int>() << value.toInt();
+}
+
+QSurfaceFormat surfaceFormatFromEnvironment() {
+  QSurfaceFormat format;
+
+  format.setRenderableType(QSurfaceFormat::OpenGLES);
+  format.setSamples(qEnvironmentVariableIntValue("SAMPLES"));
+  format.setDepthBufferSize(qEnvironmentVariableIntValue("DEPTH_SIZE"));
+  format.setStencilBufferSize(qEnvironmentVariableIntValue("STENCIL_SIZE"));
+  setColorDepth(&format, qEnvironmentVariableIntValue("COLOR_DEPTH"));
+  format.setSwapBehavior(static_cast<QSurfaceFormat::SwapBehavior>(
+      swapBehaviorFromName(qgetenv("SWAP_BEHAVIOR"))));
+  if (qEnvironmentVariableIsSet("SWAP_INTERVAL"))
+    format.setSwapInterval(qEnvironmentVariableIntValue("SWAP_INTERVAL"));
+
+  return format;
+}
+
+QString describeSurfaceFormat(const QSurfaceFormat &format) {
+  QString color;
+
+  if (format.redBufferSize() < 0)
+    color = QStringLiteral("any");
+  else
+    color = QStringLiteral("%1%2%3%4")
+                .arg(format.redBufferSize())
+                .arg(format.greenBufferSize())
+                .arg(format.blueBufferSize())
+                .arg(std::max(format.alphaBufferSize(), 0));
+
+  return QStringLiteral(
+             "samples %1 depth %2 stencil %3 rgba %4 swap %5 interval %6")
+      .arg(std::max(format.samples(), 0))
+      .arg(std::max(format.depthBufferSize(), 0))
+      .arg(std::max(format.stencilBufferSize(), 0))
+      .arg(color)
+      .arg(QLatin1String(swapBehaviorName(format.swapBehavior())))
+      .arg(format.swapInterval());
+}
+
+QString describeCurrentEglConfig() {
+  const EGLDisplay display = eglGetCurrentDisplay();
+  const EGLContext context = eglGetCurrentContext();
+  EGLint id = 0;
+  EGLint count = 0;
+  EGLConfig config;
+
+  if (display == EGL_NO_DISPLAY || context == EGL_NO_CONTEXT) return QString();
+
+  eglQueryContext(display, context, EGL_CONFIG_ID, &id);
+
+  const EGLint attributes[] = {EGL_CONFIG_ID, id, EGL_NONE};
+
+  if (!eglChooseConfig(display, attributes, &config, 1, &count) || !count)
+    return QString();
+
+  EGLint red, green, blue, alpha, depth, stencil, samples;
+
+  eglGetConfigAttrib(display, config, EGL_RED_SIZE, &red);
+  eglGetConfigAttrib(display, config, EGL_GREEN_SIZE, &green);
+  eglGetConfigAttrib(display, config, EGL_BLUE_SIZE, &blue);
+  eglGetConfigAttrib(display, config, EGL_ALPHA_SIZE, &alpha);
+  eglGetConfigAttrib(display, config, EGL_DEPTH_SIZE, &depth);
+  eglGetConfigAttrib(display, config, EGL_STENCIL_SIZE, &stencil);
+  eglGetConfigAttrib(display, config, EGL_SAMPLES, &samples);
+
+  return QStringLiteral(
+             "config %1: samples %2 depth %3 stencil %4 rgba %5%6%7%8")
+      .arg(id)
+      .arg(samples)
+      .arg(depth)
+      .arg(stencil)
+      .arg(red)
+      .arg(green)
+      .arg(blue)
+      .arg(alpha);
+}
+
+SurfaceFormatSweep::SurfaceFormatSweep(const int frames,
+                                       const EGLWindow::RenderMode mode,
+                                       const bool overlay, QObject *parent)
+    : QObject(parent),
+      index(-1),
+      frames(frames),
+      mode(mode),
+      overlay(overlay),
+      window(nullptr),
+      frameCount(0) {
+  const QList<int> samples = sweepValues("SAMPLES", {0, 2, 4, 8});
+  const QList<int> depths = sweepValues("DEPTH_SIZE", {0, 24});
+  const QList<int> colors = sweepValues("COLOR_DEPTH", {16, 24, 32});
+  const QList<int> swaps = sweepValues(
+      "SWAP_BEHAVIOR",
+      {QSurfaceFormat::DoubleBuffer, QSurfaceFormat::TripleBuffer});
+  const QList<int> swapIntervals = sweepValues("SWAP_INTERVAL", {1, 0});
+  const bool stencilPinned = qEnvironmentVariableIsSet("STENCIL_SIZE");
+
+  for (const int sampleCount : samples)
+    for (const int depth : depths)
+      for (const int color : colors)
+        for (const int swap : swaps)
+          for (const int interval : swapIntervals) {
+            QSurfaceFormat format;
+
+            format.setRenderableType(QSurfaceFormat::OpenGLES);
+            format.setSamples(sampleCount);
+            format.setDepthBufferSize(depth);
+            // depth and stencil usually come as one D24S8 buffer
+            format.setStencilBufferSize(
+                stencilPinned ? qEnvironmentVariableIntValue("STENCIL_SIZE")
+                              : (depth ? 8 : 0));
+            setColorDepth(&format, color);
+            format.setSwapBehavior(
+                static_cast<QSurfaceFormat::SwapBehavior>(swap));
+            format.setSwapInterval(interval);
+            formats.append(format);
+          }
+
+  intervals.reserve(frames);
+}
+
+SurfaceFormatSweep::~SurfaceFormatSweep() { delete window; }
+
+void SurfaceFormatSweep::start() {
+  printf("format sweep: %d combinations, %d frames each\n", formats.size(),
+         frames);
+  next();
+}
+
+void SurfaceFormatSweep::next() {
+  if (window) {
+    disconnect(window, nullptr, this, nullptr);
+    window->setRendering(false);
+    window->deleteLater();
+    window = nullptr;
+  }
+
+  if (++index >= formats.size()) {
+    showResults();
+    QCoreApplication::quit();
+    return;
+  }
+
+  chosen.clear();
+  frameCount = 0;
+  intervals.clear();
+
+  window = new EGLWindow;
+  window->setFormat(formats[index]);
+  window->setRenderMode(mode);
+  window->setOverlay(overlay);
+  connect(window, &EGLWindow::frameSwapped, this,
+          &SurfaceFormatSweep::frameSwapped);
+  window->showFullScreen();
+  window->setRendering(true);
+}
+
+void SurfaceFormatSweep::frameSwapped() {
+  // the window's context is still current right after its swap
+  if (chosen.isEmpty()) chosen = describeCurrentEglConfig();
+
+  ++frameCount;
+
+  if (frameCount <= warmupFrames) {
+    frameTimer.start();
+    return;
+  }
+
+  intervals.push_back(frameTimer.nsecsElapsed() / 1000000.0);
+  frameTimer.restart();
+
+  if (static_cast<int>(intervals.size()) < frames) return;
+
+  std::vector<double> sorted(intervals);
+  std::sort(sorted.begin(), sorted.end());
+
+  double total = 0.0;
+  for (const double interval : sorted) total += interval;
+
+  Result result;
+  result.requested = describeSurfaceFormat(formats[index]);
+  result.chosen = chosen.isEmpty() ? QStringLiteral("not EGL") : chosen;
+  result.averageMs = total / sorted.size();
+  result.p99Ms = sorted[(sorted.size() - 1) * 99 / 100];
+  result.maxMs = sorted.back();
+  results.append(result);
+
+  printf("%s -> %s: %.2f ms avg, %.2f ms p99, %.2f ms max\n",
+         qPrintable(result.requested), qPrintable(result.chosen),
+         result.averageMs, result.p99Ms, result.maxMs);
+  fflush(stdout);
+
+  // the window is the sender, replace it once its event is done
+  QTimer::singleShot(0, this, &SurfaceFormatSweep::next);
+}
+
+void SurfaceFormatSweep::showResults() const {
+  printf("\nformat sweep results, fastest first:\n");
+
+  QList<Result> sorted = results;
+  std::sort(sorted.begin(), sorted.end(), [](const Result &a, const Result &b) {
+    return a.averageMs < b.averageMs;
+  });
+
+  for (const Result &result : sorted)
+    printf("%8.2f ms  %8.1f FPS  %s -> %s\n", result.averageMs,
+           result.averageMs > 0.0 ? 1000.0 / result.averageMs : 0.0,
+           qPrintable(result.requested), qPrintable(result.chosen));
+}
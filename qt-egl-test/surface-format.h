@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2026  RDK Management
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QSurfaceFormat>
+
+#include "egl-window.h"
+
+// Surface format requested from the environment:
+//   SAMPLES        MSAA samples, default 0
+//   DEPTH_SIZE     depth buffer bits, default 0
+//   STENCIL_SIZE   stencil buffer bits, default 0
+//   COLOR_DEPTH    16 (565), 24 (888) or 32 (8888), default platform choice
+//   SWAP_BEHAVIOR  default, single, double or triple
+//   SWAP_INTERVAL  0 unthrottled, default 1
+QSurfaceFormat surfaceFormatFromEnvironment();
+
+QString describeSurfaceFormat(const QSurfaceFormat &format);
+
+// Attributes of the EGL config behind the current context, or an empty
+// string when the platform plugin does not use EGL.
+QString describeCurrentEglConfig();
+
+// Renders a fixed number of frames with each combination of samples,
+// depth/stencil, color depth, swap behavior and swap interval, one window
+// at a time, and reports the EGL config chosen for it and the frame time.
+// Dimensions pinned by the variables above are not swept.
+class SurfaceFormatSweep : public QObject {
+  Q_OBJECT
+ public:
+  SurfaceFormatSweep(const int frames, const EGLWindow::RenderMode mode,
+                     const bool overlay, QObject *parent = nullptr);
+  ~SurfaceFormatSweep();
+
+  void start();
+
+ private slots:
+  void frameSwapped();
+  void next();
+
+ private:
+  struct Result {
+    QString requested;
+    QString chosen;
+    double averageMs;
+    double p99Ms;
+    double maxMs;
+  };
+
+  void showResults() const;
+
+  QList<QSurfaceFormat> formats;
+  int index;
+  int frames;
+  EGLWindow::RenderMode mode;
+  bool overlay;
+
+  EGLWindow *window;
+  QString chosen;
+  int frameCount;
+  QElapsedTimer frameTimer;
+  std::vector<double> intervals;
+  QList<Result> results;
+};
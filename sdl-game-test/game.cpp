@@ -18,7 +18,9 @@
  */
 
 #include "game.hpp"
+#include <cstdlib>
 #include <iostream>
+#include <sstream>
 
 using std::cout;
 using std::endl;
@@ -32,6 +34,26 @@ static const int WINDOW_WIDTH = 800;
 static const int WINDOW_HEIGHT = 600;
 static const int PLAYER_WIDTH = 24;
 static const int PLAYER_HEIGHT = 26;
+static const string TITLE_MESSAGE = "DAC example application";
+
+#ifndef RESOURCE_DIR
+#define RESOURCE_DIR "/usr/share/resources"
+#endif
+
+// RESOURCE_DIR and FONT override where the assets are loaded from
+static string resourcePath(const string& name)
+{
+    const char* dir = getenv("RESOURCE_DIR");
+
+    return string(dir ? dir : RESOURCE_DIR) + "/" + name;
+}
+
+static string fontPath()
+{
+    const char* font = getenv("FONT");
+
+    return font ? font : "/usr/share/fonts/truetype/AbyssinicaSIL-R.ttf";
+}
 
 Game::Game()
 {
@@ -63,6 +85,12 @@ Game::Game()
 
     rend = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED); 
 
+    if (rend == nullptr)
+    {
+        cout << "No accelerated renderer, using the software one" << endl;
+        rend = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
+
     if (rend == nullptr)
     {
         cout << "Error during SDL renderer creation" << endl;
@@ -70,14 +98,14 @@ Game::Game()
     }
 
     TTF_Init();
-    font = TTF_OpenFont("/usr/share/fonts/truetype/AbyssinicaSIL-R.ttf", 32);
+    font = TTF_OpenFont(fontPath().c_str(), 32);
 
     if (font == nullptr)
     {
         throw std::runtime_error("TTF_OpenFont failed");
     }
 
-    player.setImage("/usr/share/resources/player.png", rend);
+    player.setImage(resourcePath("player.png"), rend);
     player.setDest(Object::Coordinates{100,375,PLAYER_WIDTH*3,PLAYER_HEIGHT*3});
 
     idle = player.createAnimation(1, PLAYER_WIDTH, PLAYER_HEIGHT, 4, 20);
@@ -86,7 +114,22 @@ Game::Game()
 
     player.setCurAnimation(idle);
 
-    loadMap("/usr/share/resources/1.level");
+    loadMap(resourcePath("1.level"));
+
+    const char* replayFile = getenv("REPLAY");
+    if (replayFile != nullptr)
+    {
+        const char* loops = getenv("REPLAY_LOOPS");
+        if (loops != nullptr && atoi(loops) > 0)
+        {
+            replayLoops = atoi(loops);
+        }
+        loadReplay(replayFile);
+        if (replay.empty())
+        {
+            throw std::runtime_error("REPLAY script is empty");
+        }
+    }
 
     mainLoop();
 
@@ -94,6 +137,11 @@ Game::Game()
 
 Game::~Game()
 {
+    if (msgTex != nullptr)
+    {
+        SDL_DestroyTexture(msgTex);
+    }
+
     // destroy renderer 
     SDL_DestroyRenderer(rend); 
 
@@ -108,11 +156,26 @@ Game::~Game()
 
 void Game::mainLoop()
 {
+    Uint64 start = SDL_GetPerformanceCounter();
+    int frames = 0;
+
     while(running)
     {
         render();
         keyInput();
+        if (!replay.empty())
+        {
+            replayInput();
+        }
         update();
+        ++frames;
+    }
+
+    if (!replay.empty())
+    {
+        double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        cout << "replay: " << frames << " frames in " << ms << " ms, "
+             << ms * 1000.0 / frames << " us per frame" << endl;
     }
 }
 
@@ -133,12 +196,12 @@ void Game::render()
 
     drawObject(player);
 
-    drawMsg("DAC example application", 170, 100, 255, 255, 255);
+    drawMsg(TITLE_MESSAGE, 170, 100, 255, 255, 255);
 
     SDL_RenderPresent(rend);
 
     timeSinceLastFrame = SDL_GetTicks() - lastFrame;
-    if (timeSinceLastFrame < (1000/60))
+    if (replay.empty() && timeSinceLastFrame < (1000/60))
     {
         SDL_Delay((1000/60) - timeSinceLastFrame); 
     }
@@ -259,7 +322,7 @@ void Game::loadMap(const string& s)
     inputFile >> mapY;
 
     Object tmpObj;
-    tmpObj.setImage("/usr/share/resources/mapTile.png", rend);
+    tmpObj.setImage(resourcePath("mapTile.png"), rend);
 
 
     for(int h = 0; h < mapHeight; ++h)
@@ -282,6 +345,66 @@ void Game::loadMap(const string& s)
 
 }
 
+// A replay script has one "<frames> <idle|left|right>" step per line,
+// lines starting with # are comments.
+void Game::loadReplay(const string& s)
+{
+    std::ifstream inputFile(s.c_str());
+    string line;
+
+    if(!inputFile)
+    {
+        cout << "Error during replay file read." << endl;
+        return;
+    }
+
+    while(std::getline(inputFile, line))
+    {
+        std::istringstream fields(line);
+        ReplayStep step;
+        string action;
+
+        if(line.empty() || line[0] == '#' || !(fields >> step.frames >> action) || step.frames <= 0)
+        {
+            continue;
+        }
+        step.left = (action == "left");
+        step.right = (action == "right");
+        replay.push_back(step);
+    }
+}
+
+// Plays the replay script in place of the keyboard, stops the game when
+// it has been played REPLAY_LOOPS times.
+void Game::replayInput()
+{
+    if(replayFrame == replay[replayStep].frames)
+    {
+        replayFrame = 0;
+        if(++replayStep == replay.size())
+        {
+            replayStep = 0;
+            if(--replayLoops == 0)
+            {
+                running = false;
+                return;
+            }
+        }
+    }
+
+    const ReplayStep& step = replay[replayStep];
+    if(replayFrame == 0 && (step.left != left || step.right != right))
+    {
+        left = step.left;
+        right = step.right;
+        if(!left && !right)
+        {
+            player.setCurAnimation(idle);
+        }
+    }
+    ++replayFrame;
+}
+
 bool Game::mapCollision(const Object& obj1, int xPositionDelta)
 {
     if(obj1.getDest().x + xPositionDelta < 0 ||
@@ -304,23 +427,35 @@ bool Game::mapCollision(const Object& obj1, int xPositionDelta)
 
 void Game::drawMsg(const string& msg, int x, int y, int r, int g, int b)
 {
-    SDL_Surface* surf;
-    SDL_Texture* tex;
-    SDL_Color color;
-    color.r = r;
-    color.g = g;
-    color.b = b;
-
-    surf = TTF_RenderText_Solid(font, msg.c_str(), color);
-    tex = SDL_CreateTextureFromSurface(rend, surf);
-
-    SDL_Rect rect;
-    rect.x = x;
-    rect.y = y;
-    rect.w = surf->w;
-    rect.h = surf->h;
-
-    SDL_FreeSurface(surf);
-    SDL_RenderCopy(rend, tex, nullptr, &rect);
-    SDL_DestroyTexture(tex);
+    if (msgTex == nullptr || msg != msgText ||
+        msgColor.r != r || msgColor.g != g || msgColor.b != b)
+    {
+        SDL_Color color;
+        color.r = r;
+        color.g = g;
+        color.b = b;
+        color.a = 255;
+
+        SDL_Surface* surf = TTF_RenderText_Solid(font, msg.c_str(), color);
+        if (surf == nullptr)
+        {
+            return;
+        }
+
+        if (msgTex != nullptr)
+        {
+            SDL_DestroyTexture(msgTex);
+        }
+        msgTex = SDL_CreateTextureFromSurface(rend, surf);
+        msgRect.w = surf->w;
+        msgRect.h = surf->h;
+        SDL_FreeSurface(surf);
+
+        msgText = msg;
+        msgColor = color;
+    }
+
+    msgRect.x = x;
+    msgRect.y = y;
+    SDL_RenderCopy(rend, msgTex, nullptr, &msgRect);
 }
@@ -46,8 +46,18 @@ public:
     void drawMap();
     void drawMsg(const std::string& msg, int x, int y, int r, int g, int b);
     bool mapCollision(const Object& obj1, int xPositionDelta);
+    void loadReplay(const std::string& s);
+    void replayInput();
 
 private:
+    // one line of a replay script: hold a direction for some frames
+    struct ReplayStep
+    {
+        int frames;
+        bool left;
+        bool right;
+    };
+
     TTF_Font* font{nullptr};
     std::vector<Object> backgroundMap;
     bool running{true};
@@ -62,6 +72,18 @@ private:
     bool left{false};
     bool right{false};
     int idle, runLeft, runRight;
+
+    // last message drawn by drawMsg, only rendered again when it changes
+    std::string msgText;
+    SDL_Color msgColor{0, 0, 0, 0};
+    SDL_Texture* msgTex{nullptr};
+    SDL_Rect msgRect{0, 0, 0, 0};
+
+    // REPLAY mode: scripted input, no frame rate cap
+    std::vector<ReplayStep> replay;
+    size_t replayStep{0};
+    int replayFrame{0};
+    int replayLoops{1};
 };
 
 
@@ -30,6 +30,7 @@ int main(int argc, char const *argv[])
     catch(std::exception& e)
     {
         std::cout << e.what() << std::endl;
+        return 1;
     }
     return 0;
 }
@@ -223,6 +223,11 @@ int main(int argc, char** argv)
 
     glUseProgram(shaderProg);
 
+    // Look the locations up once, not every frame
+    GLint posAttrib = glGetAttribLocation(shaderProg, "position");
+    GLint uniColor1 = glGetUniformLocation(shaderProg, "uniformColor1");
+    GLint uniColor2 = glGetUniformLocation(shaderProg, "uniformColor2");
+
     float fragmentColor1 = 0.5f;
     bool running = true;
 
@@ -253,17 +258,12 @@ int main(int argc, char** argv)
         auto timeNow = std::chrono::high_resolution_clock::now();
         float time = std::chrono::duration_cast<std::chrono::duration<float>>(timeNow - timeStart).count();
 
-        GLint posAttrib = glGetAttribLocation(shaderProg, "position");
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
         glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0);
         glEnableVertexAttribArray(posAttrib);
 
         glUseProgram(shaderProg);
 
-        // Get the location of the color uniform
-        GLshort uniColor1 = glGetUniformLocation(shaderProg, "uniformColor1");
-        GLshort uniColor2 = glGetUniformLocation(shaderProg, "uniformColor2");
-
         // Color set by keyboard input
         glUniform1f(uniColor1, fragmentColor1);
 
@@ -27,39 +27,169 @@
 
 //    GL: gcc -o wayland-egl wayland-egl.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl)
 // epoxy: gcc -DHAVE_EPOXY -o wayland-egl wayland-egl.c $(pkg-config --cflags --libs epoxy wayland-client wayland-egl)
+//
+// wp_presentation feedback (optional):
+//   P=$(pkg-config --variable=pkgdatadir wayland-protocols)/stable/presentation-time/presentation-time.xml
+//   wayland-scanner client-header $P presentation-time-client-protocol.h
+//   wayland-scanner private-code $P presentation-time-protocol.c
+//   gcc -DHAVE_PRESENTATION_TIME -I. -o wayland-egl wayland-egl.c presentation-time-protocol.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl)
+//
+// xdg-shell (preferred over wl_shell when the compositor offers xdg_wm_base):
+//   X=$(pkg-config --variable=pkgdatadir wayland-protocols)/stable/xdg-shell/xdg-shell.xml
+//   wayland-scanner client-header $X xdg-shell-client-protocol.h
+//   wayland-scanner private-code $X xdg-shell-protocol.c
+//   gcc -DHAVE_XDG_SHELL -I. -o wayland-egl wayland-egl.c xdg-shell-protocol.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl)
+//
+// headless GBM backend (BACKEND=gbm, the surfaceless and pbuffer backends need nothing extra):
+//   gcc -DHAVE_GBM -o wayland-egl wayland-egl.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl gbm)
 
 #ifdef HAVE_EPOXY
 #  include <epoxy/egl.h>
 #else
 #  include <EGL/egl.h>
+#  include <EGL/eglext.h>
 #  include <GLES2/gl2.h>
 #endif
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
 #include <wayland-client.h>
 #include <wayland-egl.h>
+#ifdef HAVE_PRESENTATION_TIME
+#  include "presentation-time-client-protocol.h"
+#endif
+#ifdef HAVE_XDG_SHELL
+#  include "xdg-shell-client-protocol.h"
+#endif
+#ifdef HAVE_GBM
+#  include <gbm.h>
+#endif
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#  define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_PLATFORM_GBM_KHR
+#  define EGL_PLATFORM_GBM_KHR 0x31D7
+#endif
+
+// BACKEND=surfaceless|pbuffer|gbm runs the same render loop without a
+// compositor, e.g. on build machines with Mesa software rendering
+enum backend {
+	BACKEND_WAYLAND,
+	BACKEND_SURFACELESS,
+	BACKEND_PBUFFER,
+	BACKEND_GBM
+};
+static const char *backend_names[] = { "wayland", "surfaceless", "pbuffer", "gbm" };
 
 static EGLint swap_interval = 1;
 static int32_t width = 1920;
 static int32_t height = 1080;
+static char frame_callback = 1;
+static char presentation_feedback = 1;
+static char partial_damage = 0;
+static enum backend backend = BACKEND_WAYLAND;
+static unsigned long frame_limit = 0;
 
 static struct wl_display *display;
 static struct wl_compositor *compositor = NULL;
 static struct wl_shell *shell = NULL;
+#ifdef HAVE_XDG_SHELL
+static struct xdg_wm_base *wm_base = NULL;
+#endif
+#ifdef HAVE_PRESENTATION_TIME
+static struct wp_presentation *presentation = NULL;
+static clockid_t presentation_clock = CLOCK_MONOTONIC;
+#endif
 static EGLDisplay egl_display;
-static char running = 1;
+static volatile sig_atomic_t running = 1;
+
+static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage = NULL;
+static char has_buffer_age = 0;
+
+// number of past frames whose damage is kept for buffer age repaints
+#define DAMAGE_HISTORY 4
 
 struct window {
 	EGLContext egl_context;
 	struct wl_surface *surface;
 	struct wl_shell_surface *shell_surface;
+#ifdef HAVE_XDG_SHELL
+	struct xdg_surface *xdg_surface;
+	struct xdg_toplevel *xdg_toplevel;
+	int32_t pending_width, pending_height;
+	char configured;
+#endif
 	struct wl_egl_window *egl_window;
 	EGLSurface egl_surface;
+	struct wl_callback *frame_callback;
+	double commit_ms;
+	int32_t width, height;
 	int color;
+	// DAMAGE=1: a box moving over a static background, each frame's damage
+	// is the old and the new box position in GL (bottom-left) coordinates
+	int box_x;
+	char full_redraw;
+	EGLint damage[DAMAGE_HISTORY][2][4];
+	unsigned int damage_frame;
+	// headless backends
+	int drm_fd;
+	void *gbm_device;
+	void *gbm_surface;
+	void *gbm_front_buffer;
+};
+
+// everything glClear has written, for the fill rate in bytes per second
+static unsigned long long pixels_filled = 0;
+static int bytes_per_pixel = 4;
+static unsigned long frame_count = 0;
+
+// BENCH=clear|quad|blend|texture draws that fill rate case instead of the
+// plain clear, with LAYERS full screen quads of overdraw and a TEXTURE_SIZE
+// texture repeated one texel per pixel; BENCH=all runs every case (textures
+// of 64 to 2048 texels) for BENCH_FRAMES frames each and prints a table
+enum bench_mode { BENCH_CLEAR, BENCH_QUAD, BENCH_BLEND, BENCH_TEXTURE };
+static const char *bench_names[] = { "clear", "quad", "blend", "texture" };
+#define BENCH_MAX_CASES 8
+struct bench_case {
+	enum bench_mode mode;
+	int texture_size;
+	unsigned long frames;
+	// written since timing started with the second frame
+	unsigned long long pixels;
+	double start_ms, end_ms;
 };
+static struct {
+	const char *mode;
+	int layers;
+	int texture_size;
+	unsigned long frames_per_case;
+	struct bench_case cases[BENCH_MAX_CASES];
+	int case_count;
+	int current;
+	GLuint color_prog, texture_prog, vbo, texture;
+	GLint color, texel_scale;
+	int loaded_size;
+} bench = { NULL, 4, 256, 300 };
+
+// frame callback latency, i.e. time from commit to the compositor's "done"
+static double latency_sum_ms = 0;
+static double latency_max_ms = 0;
+static unsigned long latency_count = 0;
+
+static double now_ms () {
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
 
 // listeners
 static void registry_add_object (void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version) {
@@ -69,6 +199,16 @@ static void registry_add_object (void *data, struct wl_registry *registry, uint3
 	else if (!strcmp(interface,"wl_shell")) {
 		shell = wl_registry_bind (registry, name, &wl_shell_interface, 1);
 	}
+#ifdef HAVE_XDG_SHELL
+	else if (!strcmp(interface,"xdg_wm_base")) {
+		wm_base = wl_registry_bind (registry, name, &xdg_wm_base_interface, 1);
+	}
+#endif
+#ifdef HAVE_PRESENTATION_TIME
+	else if (!strcmp(interface,"wp_presentation") && presentation_feedback) {
+		presentation = wl_registry_bind (registry, name, &wp_presentation_interface, 1);
+	}
+#endif
 }
 static void registry_remove_object (void *data, struct wl_registry *registry, uint32_t name) {
 
@@ -78,21 +218,181 @@ static struct wl_registry_listener registry_listener = {&registry_add_object, &r
 static void shell_surface_ping (void *data, struct wl_shell_surface *shell_surface, uint32_t serial) {
 	wl_shell_surface_pong (shell_surface, serial);
 }
-static void shell_surface_configure (void *data, struct wl_shell_surface *shell_surface, uint32_t edges, int32_t width, int32_t height) {
-	struct window *window = data;
+static void resize_window (struct window *window, int32_t width, int32_t height) {
+	if (width <= 0 || height <= 0 || (width == window->width && height == window->height)) return;
 	wl_egl_window_resize (window->egl_window, width, height, 0, 0);
+	window->width = width;
+	window->height = height;
+	window->full_redraw = 1;
+}
+static void shell_surface_configure (void *data, struct wl_shell_surface *shell_surface, uint32_t edges, int32_t width, int32_t height) {
+	resize_window (data, width, height);
 }
 static void shell_surface_popup_done (void *data, struct wl_shell_surface *shell_surface) {
 
 }
 static struct wl_shell_surface_listener shell_surface_listener = {&shell_surface_ping, &shell_surface_configure, &shell_surface_popup_done};
 
+#ifdef HAVE_XDG_SHELL
+static void wm_base_ping (void *data, struct xdg_wm_base *wm_base, uint32_t serial) {
+	xdg_wm_base_pong (wm_base, serial);
+}
+static struct xdg_wm_base_listener wm_base_listener = {&wm_base_ping};
+
+// toplevel configure only stores the new state, it is applied and acked
+// atomically in xdg_surface.configure before the next commit
+static void xdg_toplevel_configure (void *data, struct xdg_toplevel *toplevel, int32_t width, int32_t height, struct wl_array *states) {
+	struct window *window = data;
+	window->pending_width = width;
+	window->pending_height = height;
+}
+static void xdg_toplevel_close (void *data, struct xdg_toplevel *toplevel) {
+	running = 0;
+}
+static struct xdg_toplevel_listener xdg_toplevel_listener = {&xdg_toplevel_configure, &xdg_toplevel_close};
+
+static void xdg_surface_configure (void *data, struct xdg_surface *xdg_surface, uint32_t serial) {
+	struct window *window = data;
+	// 0x0 means the client picks its own size
+	resize_window (window, window->pending_width, window->pending_height);
+	xdg_surface_ack_configure (xdg_surface, serial);
+	window->configured = 1;
+}
+static struct xdg_surface_listener xdg_surface_listener = {&xdg_surface_configure};
+#endif
+
+static void frame_done (void *data, struct wl_callback *callback, uint32_t time) {
+	struct window *window = data;
+	const double latency = now_ms() - window->commit_ms;
+
+	latency_sum_ms += latency;
+	if (latency > latency_max_ms) latency_max_ms = latency;
+	latency_count++;
+
+	wl_callback_destroy (callback);
+	window->frame_callback = NULL;
+}
+static struct wl_callback_listener frame_listener = {&frame_done};
+
+#ifdef HAVE_PRESENTATION_TIME
+// Submit-to-present latency, collected from wp_presentation_feedback events
+// into a fixed histogram so nothing is allocated per frame.
+#define FEEDBACK_SLOTS 64
+#define LATENCY_BIN_US 250
+#define LATENCY_BINS 400
+
+struct feedback_slot {
+	struct wp_presentation_feedback *feedback;
+	uint64_t submit_us;
+};
+
+static struct feedback_slot feedback_slots[FEEDBACK_SLOTS];
+static unsigned int feedback_next = 0;
+
+static struct {
+	unsigned long presented;
+	unsigned long discarded;
+	unsigned long dropped;
+	unsigned long vsync;
+	unsigned long hw_clock;
+	unsigned long hw_completion;
+	unsigned long zero_copy;
+	uint32_t refresh_ns;
+	uint64_t max_us;
+	unsigned long bins[LATENCY_BINS + 1];
+} present_stats;
+
+static uint64_t presentation_now_us () {
+	struct timespec ts;
+	clock_gettime (presentation_clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void presentation_clock_id (void *data, struct wp_presentation *presentation, uint32_t clk_id) {
+	presentation_clock = clk_id;
+}
+static struct wp_presentation_listener presentation_listener = {&presentation_clock_id};
+
+static void feedback_release (struct feedback_slot *slot) {
+	wp_presentation_feedback_destroy (slot->feedback);
+	slot->feedback = NULL;
+}
+static void feedback_sync_output (void *data, struct wp_presentation_feedback *feedback, struct wl_output *output) {
+
+}
+static void feedback_presented (void *data, struct wp_presentation_feedback *feedback, uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo, uint32_t flags) {
+	struct feedback_slot *slot = data;
+	const uint64_t present_us = ((((uint64_t)tv_sec_hi) << 32) + tv_sec_lo) * 1000000 + tv_nsec / 1000;
+	const uint64_t latency_us = present_us > slot->submit_us ? present_us - slot->submit_us : 0;
+	const uint64_t bin = latency_us / LATENCY_BIN_US;
+
+	present_stats.presented++;
+	present_stats.bins[bin < LATENCY_BINS ? bin : LATENCY_BINS]++;
+	if (latency_us > present_stats.max_us) present_stats.max_us = latency_us;
+	present_stats.refresh_ns = refresh;
+	if (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC) present_stats.vsync++;
+	if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK) present_stats.hw_clock++;
+	if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION) present_stats.hw_completion++;
+	if (flags & WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY) present_stats.zero_copy++;
+
+	feedback_release (slot);
+}
+static void feedback_discarded (void *data, struct wp_presentation_feedback *feedback) {
+	present_stats.discarded++;
+	feedback_release (data);
+}
+static struct wp_presentation_feedback_listener feedback_listener = {&feedback_sync_output, &feedback_presented, &feedback_discarded};
+
+// must be called before eglSwapBuffers so the feedback applies to that commit
+static void request_feedback (struct wl_surface *surface) {
+	struct feedback_slot *slot = &feedback_slots[feedback_next];
+	feedback_next = (feedback_next + 1) % FEEDBACK_SLOTS;
+
+	if (slot->feedback) {
+		// compositor is more than FEEDBACK_SLOTS frames behind, give up on this one
+		present_stats.dropped++;
+		feedback_release (slot);
+	}
+
+	slot->feedback = wp_presentation_feedback (presentation, surface);
+	slot->submit_us = presentation_now_us();
+	wp_presentation_feedback_add_listener (slot->feedback, &feedback_listener, slot);
+}
+
+static double latency_percentile (double p) {
+	const unsigned long target = present_stats.presented * p;
+	unsigned long count = 0;
+	int i;
+
+	for (i = 0; i < LATENCY_BINS; i++) {
+		count += present_stats.bins[i];
+		if (count > target) break;
+	}
+	// bin upper edge, but never above the largest sample seen
+	return ((i + 1) * LATENCY_BIN_US < present_stats.max_us) ? (i + 1) * LATENCY_BIN_US / 1000.0 : present_stats.max_us / 1000.0;
+}
+
+static void show_presentation_stats () {
+	if (present_stats.presented) {
+		printf("present latency p50 %.2f ms p90 %.2f ms p99 %.2f ms max %.2f ms, refresh %.2f ms, presented %lu discarded %lu dropped %lu, vsync %lu hw-clock %lu hw-completion %lu zero-copy %lu\n",
+			latency_percentile (0.50), latency_percentile (0.90), latency_percentile (0.99),
+			present_stats.max_us / 1000.0, present_stats.refresh_ns / 1000000.0,
+			present_stats.presented, present_stats.discarded, present_stats.dropped, present_stats.vsync,
+			present_stats.hw_clock, present_stats.hw_completion, present_stats.zero_copy);
+	} else if (present_stats.discarded || present_stats.dropped) {
+		printf("present: no frame presented, %lu discarded %lu dropped\n", present_stats.discarded, present_stats.dropped);
+	}
+	memset (&present_stats, 0, sizeof(present_stats));
+}
+#endif
+
 static void show_fps() {
 	struct timeval curTime;
 	time_t nowMs;
 	static time_t lastPrintTime = 0;
 	static time_t lastPrintFrame = 0;
 	static unsigned long frame = 0;
+	static unsigned long long lastPrintPixels = 0;
 
 	gettimeofday(&curTime, NULL);
 	nowMs =  curTime.tv_usec / 1000;
@@ -102,10 +402,25 @@ static void show_fps() {
 
 	if (nowMs - lastPrintTime >= 5000 || lastPrintFrame == 0) {
 		if (nowMs - lastPrintTime != 0 && lastPrintTime != 0) {
-			const float fps = (float) (frame - lastPrintFrame) / ((nowMs - lastPrintTime) / 1000.0f);
-			printf("FPS: %.2f\n", fps);
+			const float seconds = (nowMs - lastPrintTime) / 1000.0f;
+			const float fps = (float) (frame - lastPrintFrame) / seconds;
+			const double mbps = (pixels_filled - lastPrintPixels) * bytes_per_pixel / seconds / 1000000.0;
+			const double mpixels = (pixels_filled - lastPrintPixels) / seconds / 1000000.0;
+			if (latency_count) {
+				printf("FPS: %.2f, fill %.1f Mpixels/s %.1f MB/s, frame callback latency avg %.2f ms max %.2f ms\n", fps, mpixels, mbps, latency_sum_ms / latency_count, latency_max_ms);
+			} else {
+				printf("FPS: %.2f, fill %.1f Mpixels/s %.1f MB/s\n", fps, mpixels, mbps);
+			}
 		}
 
+		latency_sum_ms = 0;
+		latency_max_ms = 0;
+		latency_count = 0;
+#ifdef HAVE_PRESENTATION_TIME
+		if (presentation) show_presentation_stats();
+#endif
+
+		lastPrintPixels = pixels_filled;
 		lastPrintFrame = frame;
 		lastPrintTime  = nowMs;
 	}
@@ -125,35 +440,542 @@ static void create_window (struct window *window, int32_t width, int32_t height)
 	window->egl_context = eglCreateContext (egl_display, config, EGL_NO_CONTEXT, contextAttributes);
 	
 	window->surface = wl_compositor_create_surface (compositor);
-	window->shell_surface = wl_shell_get_shell_surface (shell, window->surface);
-	wl_shell_surface_add_listener (window->shell_surface, &shell_surface_listener, window);
-	wl_shell_surface_set_toplevel (window->shell_surface);
 	window->egl_window = wl_egl_window_create (window->surface, width, height);
+	window->width = width;
+	window->height = height;
+	window->shell_surface = NULL;
+#ifdef HAVE_XDG_SHELL
+	window->xdg_surface = NULL;
+	window->xdg_toplevel = NULL;
+	if (wm_base) {
+		window->configured = 0;
+		window->xdg_surface = xdg_wm_base_get_xdg_surface (wm_base, window->surface);
+		xdg_surface_add_listener (window->xdg_surface, &xdg_surface_listener, window);
+		window->xdg_toplevel = xdg_surface_get_toplevel (window->xdg_surface);
+		xdg_toplevel_add_listener (window->xdg_toplevel, &xdg_toplevel_listener, window);
+		xdg_toplevel_set_title (window->xdg_toplevel, "wayland-egl");
+		// initial commit without a buffer, no content may be attached before
+		// the first configure has been acked
+		wl_surface_commit (window->surface);
+		while (!window->configured && wl_display_dispatch (display) != -1);
+	}
+	else
+#endif
+	{
+		window->shell_surface = wl_shell_get_shell_surface (shell, window->surface);
+		wl_shell_surface_add_listener (window->shell_surface, &shell_surface_listener, window);
+		wl_shell_surface_set_toplevel (window->shell_surface);
+	}
 	window->egl_surface = eglCreateWindowSurface (egl_display, config, window->egl_window, NULL);
 	eglMakeCurrent (egl_display, window->egl_surface, window->egl_surface, window->egl_context);
+	window->frame_callback = NULL;
 	window->color = 0;
+	window->box_x = 0;
+	window->full_redraw = 1;
+	window->damage_frame = 0;
+	memset (window->damage, 0, sizeof(window->damage));
 }
 static void delete_window (struct window *window) {
+	if (window->frame_callback) wl_callback_destroy (window->frame_callback);
 	eglDestroySurface (egl_display, window->egl_surface);
 	wl_egl_window_destroy (window->egl_window);
-	wl_shell_surface_destroy (window->shell_surface);
+#ifdef HAVE_XDG_SHELL
+	if (window->xdg_toplevel) xdg_toplevel_destroy (window->xdg_toplevel);
+	if (window->xdg_surface) xdg_surface_destroy (window->xdg_surface);
+#endif
+	if (window->shell_surface) wl_shell_surface_destroy (window->shell_surface);
 	wl_surface_destroy (window->surface);
 	eglDestroyContext (egl_display, window->egl_context);
 }
+static EGLDisplay get_platform_display (EGLenum platform, void *native) {
+	const char *extensions = eglQueryString (EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display_ext;
+
+	if (!extensions || !strstr (extensions, "EGL_EXT_platform_base")) {
+		fprintf (stderr, "EGL_EXT_platform_base not supported\n");
+		return EGL_NO_DISPLAY;
+	}
+	get_platform_display_ext = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress ("eglGetPlatformDisplayEXT");
+	return get_platform_display_ext ? get_platform_display_ext (platform, native, NULL) : EGL_NO_DISPLAY;
+}
+// Display, context and a pbuffer or GBM surface for the headless backends;
+// the wayland members of the window stay NULL. Returns 0 on failure.
+static int create_headless_window (struct window *window, int32_t width, int32_t height) {
+	EGLint attributes[] = {
+		EGL_SURFACE_TYPE, backend == BACKEND_GBM ? EGL_WINDOW_BIT : EGL_PBUFFER_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+	EGL_NONE};
+	EGLint pbuffer_attributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	EGLint contextAttributes[] = { EGL_CONTEXT_MAJOR_VERSION, 2, EGL_NONE };
+	EGLConfig configs[64], config;
+	EGLint num_config = 0, buffer_size = 32;
+
+	memset (window, 0, sizeof(*window));
+	window->drm_fd = -1;
+	window->width = width;
+	window->height = height;
+	window->full_redraw = 1;
+	window->egl_surface = EGL_NO_SURFACE;
+	window->egl_context = EGL_NO_CONTEXT;
+
+	switch (backend) {
+	case BACKEND_SURFACELESS:
+		egl_display = get_platform_display (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY);
+		break;
+	case BACKEND_PBUFFER:
+		egl_display = eglGetDisplay (EGL_DEFAULT_DISPLAY);
+		break;
+	case BACKEND_GBM:
+#ifdef HAVE_GBM
+		{
+			const char *node = getenv ("GBM_DEVICE");
+			window->drm_fd = open (node ? node : "/dev/dri/renderD128", O_RDWR | O_CLOEXEC);
+			if (window->drm_fd < 0 || !(window->gbm_device = gbm_create_device (window->drm_fd))) {
+				fprintf (stderr, "unable to open a GBM device on %s\n", node ? node : "/dev/dri/renderD128");
+				return 0;
+			}
+			egl_display = get_platform_display (EGL_PLATFORM_GBM_KHR, window->gbm_device);
+		}
+#else
+		fprintf (stderr, "built without GBM support (-DHAVE_GBM)\n");
+		return 0;
+#endif
+		break;
+	default:
+		return 0;
+	}
+
+	if (egl_display == EGL_NO_DISPLAY || !eglInitialize (egl_display, NULL, NULL)) {
+		fprintf (stderr, "no %s EGL display\n", backend_names[backend]);
+		return 0;
+	}
+	eglBindAPI (EGL_OPENGL_ES_API);
+	if (!eglChooseConfig (egl_display, attributes, configs, 64, &num_config) || num_config == 0) {
+		fprintf (stderr, "no suitable EGL config\n");
+		return 0;
+	}
+	config = configs[0];
+
+#ifdef HAVE_GBM
+	if (backend == BACKEND_GBM) {
+		// the config has to match the format of the GBM buffers
+		for (EGLint i = 0; i < num_config; i++) {
+			EGLint visual = 0;
+			eglGetConfigAttrib (egl_display, configs[i], EGL_NATIVE_VISUAL_ID, &visual);
+			if (visual == GBM_FORMAT_XRGB8888) {
+				config = configs[i];
+				break;
+			}
+		}
+		window->gbm_surface = gbm_surface_create (window->gbm_device, width, height, GBM_FORMAT_XRGB8888, GBM_BO_USE_RENDERING);
+		if (window->gbm_surface) {
+			window->egl_surface = eglCreateWindowSurface (egl_display, config, (EGLNativeWindowType) window->gbm_surface, NULL);
+		}
+	} else
+#endif
+	{
+		window->egl_surface = eglCreatePbufferSurface (egl_display, config, pbuffer_attributes);
+	}
+	if (window->egl_surface == EGL_NO_SURFACE) {
+		fprintf (stderr, "unable to create a %dx%d surface: 0x%X\n", width, height, eglGetError ());
+		return 0;
+	}
+
+	window->egl_context = eglCreateContext (egl_display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (!eglMakeCurrent (egl_display, window->egl_surface, window->egl_surface, window->egl_context)) {
+		fprintf (stderr, "unable to make the context current: 0x%X\n", eglGetError ());
+		return 0;
+	}
+
+	eglGetConfigAttrib (egl_display, config, EGL_BUFFER_SIZE, &buffer_size);
+	bytes_per_pixel = (buffer_size + 7) / 8;
+	printf("backend: %s, renderer: %s\n", backend_names[backend], (const char *) glGetString (GL_RENDERER));
+	return 1;
+}
+static void delete_headless_window (struct window *window) {
+	if (egl_display != EGL_NO_DISPLAY) {
+		eglMakeCurrent (egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (window->egl_context != EGL_NO_CONTEXT) eglDestroyContext (egl_display, window->egl_context);
+		if (window->egl_surface != EGL_NO_SURFACE) eglDestroySurface (egl_display, window->egl_surface);
+		eglTerminate (egl_display);
+	}
+#ifdef HAVE_GBM
+	if (window->gbm_front_buffer) gbm_surface_release_buffer (window->gbm_surface, window->gbm_front_buffer);
+	if (window->gbm_surface) gbm_surface_destroy (window->gbm_surface);
+	if (window->gbm_device) gbm_device_destroy (window->gbm_device);
+#endif
+	if (window->drm_fd >= 0) close (window->drm_fd);
+}
+static void swap_headless (struct window *window) {
+	eglSwapBuffers (egl_display, window->egl_surface);
+#ifdef HAVE_GBM
+	if (window->gbm_surface) {
+		// nothing scans out, the previous buffer goes straight back
+		struct gbm_bo *bo = gbm_surface_lock_front_buffer (window->gbm_surface);
+		if (window->gbm_front_buffer) gbm_surface_release_buffer (window->gbm_surface, window->gbm_front_buffer);
+		window->gbm_front_buffer = bo;
+	}
+#endif
+	// a pbuffer swap waits for nothing; without this only the rate at
+	// which commands are queued would be measured
+	glFinish ();
+}
+static void clear_rect (const EGLint *rect, float r, float g, float b) {
+	pixels_filled += (unsigned long long) rect[2] * rect[3];
+	glScissor (rect[0], rect[1], rect[2], rect[3]);
+	glClearColor (r, g, b, 1.0);
+	glClear (GL_COLOR_BUFFER_BIT);
+}
+// Moves the box and repaints only what differs between the current back
+// buffer (EGL_BUFFER_AGE_EXT frames old) and the new frame. Returns the
+// number of damage rects for this frame, 0 meaning the whole surface.
+static EGLint draw_damage (struct window *window) {
+	const int32_t box_w = window->width / 8;
+	const int32_t box_h = window->height / 8;
+	EGLint *old_box, *new_box;
+	EGLint age = 0;
+	float c;
+
+	if (has_buffer_age) {
+		eglQuerySurface (egl_display, window->egl_surface, EGL_BUFFER_AGE_EXT, &age);
+	}
+
+	window->damage_frame++;
+	old_box = window->damage[(window->damage_frame - 1) % DAMAGE_HISTORY][1];
+	new_box = window->damage[window->damage_frame % DAMAGE_HISTORY][1];
+	memcpy (window->damage[window->damage_frame % DAMAGE_HISTORY][0], old_box, 4 * sizeof(EGLint));
+
+	window->box_x = (window->box_x + 4) % (window->width - box_w > 0 ? window->width - box_w : 1);
+	new_box[0] = window->box_x;
+	new_box[1] = (window->height - box_h) / 2;
+	new_box[2] = box_w;
+	new_box[3] = box_h;
+
+	glEnable (GL_SCISSOR_TEST);
+	if (window->full_redraw || age == 0 || age > DAMAGE_HISTORY) {
+		const EGLint full[4] = { 0, 0, window->width, window->height };
+		clear_rect (full, 0.0, 0.0, 0.2);
+	} else {
+		// restore the background under every box drawn since this buffer
+		// was last used, the current frame's rects included
+		for (EGLint i = 0; i < age; i++) {
+			clear_rect (window->damage[(window->damage_frame - i) % DAMAGE_HISTORY][0], 0.0, 0.0, 0.2);
+		}
+	}
+	c = window->color / 255.0;
+	clear_rect (new_box, 0.0, c, 0.0);
+	glDisable (GL_SCISSOR_TEST);
+
+	if (window->full_redraw) {
+		window->full_redraw = 0;
+		return 0;
+	}
+	return 2;
+}
+static const char *bench_vert_source =
+	"attribute vec2 pos;\n"
+	"uniform vec2 texel_scale;\n"
+	"varying vec2 uv;\n"
+	"void main() {\n"
+	"  gl_Position = vec4(pos, 0.0, 1.0);\n"
+	"  uv = (pos * 0.5 + 0.5) * texel_scale;\n"
+	"}\n";
+static const char *bench_color_source =
+	"precision mediump float;\n"
+	"uniform vec4 color;\n"
+	"void main() {\n"
+	"  gl_FragColor = color;\n"
+	"}\n";
+static const char *bench_texture_source =
+	"precision mediump float;\n"
+	"uniform sampler2D tex;\n"
+	"varying vec2 uv;\n"
+	"void main() {\n"
+	"  gl_FragColor = texture2D(tex, uv);\n"
+	"}\n";
+static GLuint bench_program (const char *frag_source) {
+	const char *sources[2] = { bench_vert_source, frag_source };
+	const GLenum types[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	GLuint prog = glCreateProgram ();
+	GLint status;
+
+	for (int i = 0; i < 2; i++) {
+		GLuint shader = glCreateShader (types[i]);
+		glShaderSource (shader, 1, &sources[i], NULL);
+		glCompileShader (shader);
+		glGetShaderiv (shader, GL_COMPILE_STATUS, &status);
+		if (!status) {
+			char log[1000];
+			GLsizei len;
+			glGetShaderInfoLog (shader, sizeof(log), &len, log);
+			fprintf (stderr, "bench: compiling shader:\n%.*s\n", len, log);
+		}
+		glAttachShader (prog, shader);
+		glDeleteShader (shader);
+	}
+	glBindAttribLocation (prog, 0, "pos");
+	glLinkProgram (prog);
+	glGetProgramiv (prog, GL_LINK_STATUS, &status);
+	if (!status) {
+		glDeleteProgram (prog);
+		return 0;
+	}
+	return prog;
+}
+static void bench_add_case (enum bench_mode mode, int texture_size) {
+	struct bench_case *c = &bench.cases[bench.case_count++];
+	memset (c, 0, sizeof(*c));
+	c->mode = mode;
+	c->texture_size = texture_size;
+}
+// Needs a current context, returns 0 for an unknown BENCH value.
+static int bench_init () {
+	static const GLfloat quad[4][2] = { { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+	static const int sweep_sizes[] = { 64, 256, 1024, 2048 };
+
+	if (bench.layers < 1) bench.layers = 1;
+	if (bench.texture_size <= 0 || (bench.texture_size & (bench.texture_size - 1))) {
+		fprintf (stderr, "TEXTURE_SIZE must be a power of two, using 256\n");
+		bench.texture_size = 256;
+	}
+	if (!strcmp (bench.mode, "all")) {
+		bench_add_case (BENCH_CLEAR, 0);
+		bench_add_case (BENCH_QUAD, 0);
+		bench_add_case (BENCH_BLEND, 0);
+		for (int i = 0; i < (int) (sizeof(sweep_sizes) / sizeof(sweep_sizes[0])); i++) {
+			bench_add_case (BENCH_TEXTURE, sweep_sizes[i]);
+		}
+	} else {
+		for (int i = 0; i < (int) (sizeof(bench_names) / sizeof(bench_names[0])); i++) {
+			if (!strcmp (bench.mode, bench_names[i])) bench_add_case (i, bench.texture_size);
+		}
+		// a single case runs until the program stops
+		bench.frames_per_case = 0;
+	}
+	if (!bench.case_count) {
+		fprintf (stderr, "unknown BENCH mode (%s)\n", bench.mode);
+		return 0;
+	}
+
+	bench.color_prog = bench_program (bench_color_source);
+	bench.texture_prog = bench_program (bench_texture_source);
+	if (!bench.color_prog || !bench.texture_prog) {
+		fprintf (stderr, "bench shaders failed to build\n");
+		return 0;
+	}
+	bench.color = glGetUniformLocation (bench.color_prog, "color");
+	bench.texel_scale = glGetUniformLocation (bench.texture_prog, "texel_scale");
+	glUseProgram (bench.texture_prog);
+	glUniform1i (glGetUniformLocation (bench.texture_prog, "tex"), 0);
+
+	glGenBuffers (1, &bench.vbo);
+	glBindBuffer (GL_ARRAY_BUFFER, bench.vbo);
+	glBufferData (GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+	glVertexAttribPointer (0, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+	glEnableVertexAttribArray (0);
+
+	glGenTextures (1, &bench.texture);
+	glBindTexture (GL_TEXTURE_2D, bench.texture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	printf("bench: %s, %d layers\n", bench.mode, bench.layers);
+	return 1;
+}
+// checkerboard of 8 texel squares
+static void bench_load_texture (int size) {
+	unsigned char *pixels;
+
+	if (size == bench.loaded_size) return;
+	pixels = malloc (size * size * 4);
+	if (!pixels) return;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			unsigned char *p = &pixels[(y * size + x) * 4];
+			p[0] = (((x >> 3) ^ (y >> 3)) & 1) ? 0xFF : 0x40;
+			p[1] = x * 255 / size;
+			p[2] = y * 255 / size;
+			p[3] = 0xFF;
+		}
+	}
+	glBindTexture (GL_TEXTURE_2D, bench.texture);
+	glTexImage2D (GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	free (pixels);
+	bench.loaded_size = size;
+}
+static int bench_finished () {
+	return bench.frames_per_case && bench.current == bench.case_count - 1 &&
+	       bench.cases[bench.current].frames >= bench.frames_per_case;
+}
+// Draws a frame of the current case, returns the number of pixels written.
+static unsigned long long bench_draw (int32_t width, int32_t height) {
+	struct bench_case *c = &bench.cases[bench.current];
+	const unsigned long long area = (unsigned long long) width * height;
+	unsigned long long pixels = 0;
+	const double now = now_ms();
+
+	// a case ends when the frame after its last one starts
+	if (bench.frames_per_case && c->frames == bench.frames_per_case) {
+		if (bench.current == bench.case_count - 1) return 0;
+		c->end_ms = now;
+		c = &bench.cases[++bench.current];
+	}
+	// the first frame warms up (shader compile, texture upload)
+	if (c->frames == 1) {
+		c->start_ms = now;
+		c->pixels = 0;
+	}
+
+	// the window may have been resized since the last frame
+	glViewport (0, 0, width, height);
+	glUseProgram (c->mode == BENCH_TEXTURE ? bench.texture_prog : bench.color_prog);
+	switch (c->mode) {
+	case BENCH_CLEAR:
+		glClearColor (0.0, (c->frames & 0xFF) / 255.0, 0.0, 1.0);
+		glClear (GL_COLOR_BUFFER_BIT);
+		pixels = area;
+		break;
+	case BENCH_QUAD:
+	case BENCH_BLEND:
+		if (c->mode == BENCH_BLEND) {
+			glClearColor (0.0, 0.0, 0.0, 1.0);
+			glClear (GL_COLOR_BUFFER_BIT);
+			pixels = area;
+			glEnable (GL_BLEND);
+			glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		for (int i = 0; i < bench.layers; i++) {
+			glUniform4f (bench.color, (float) (i + 1) / bench.layers, 0.5, (c->frames & 0xFF) / 255.0, 0.25);
+			glDrawArrays (GL_TRIANGLE_STRIP, 0, 4);
+		}
+		glDisable (GL_BLEND);
+		pixels += area * bench.layers;
+		break;
+	case BENCH_TEXTURE:
+		bench_load_texture (c->texture_size);
+		glBindTexture (GL_TEXTURE_2D, bench.texture);
+		glUniform2f (bench.texel_scale, (float) width / c->texture_size, (float) height / c->texture_size);
+		for (int i = 0; i < bench.layers; i++) {
+			glDrawArrays (GL_TRIANGLE_STRIP, 0, 4);
+		}
+		pixels = area * bench.layers;
+		break;
+	}
+	c->frames++;
+	c->pixels += pixels;
+	c->end_ms = now;
+	return pixels;
+}
+static void bench_show_results () {
+	printf("bench results (%d layers):\n", bench.layers);
+	for (int i = 0; i < bench.case_count; i++) {
+		const struct bench_case *c = &bench.cases[i];
+		const double seconds = (c->end_ms - c->start_ms) / 1000.0;
+		// finished cases are timed to the start of the next one, the
+		// current one to the start of its last frame
+		const unsigned long counted = c->frames - 1;
+		const unsigned long timed = i < bench.current ? counted : counted - 1;
+		char name[32];
+
+		if (c->frames < 3 || !timed || seconds <= 0) continue;
+		if (c->mode == BENCH_TEXTURE) {
+			snprintf (name, sizeof(name), "texture %d", c->texture_size);
+		} else {
+			snprintf (name, sizeof(name), "%s", bench_names[c->mode]);
+		}
+		printf("  %-14s %6lu frames %8.2f FPS %10.1f Mpixels/s\n", name, c->frames, timed / seconds,
+		       (double) c->pixels * timed / counted / seconds / 1000000.0);
+	}
+}
+static void bench_term () {
+	bench_show_results ();
+	if (bench.vbo) glDeleteBuffers (1, &bench.vbo);
+	if (bench.texture) glDeleteTextures (1, &bench.texture);
+	if (bench.color_prog) glDeleteProgram (bench.color_prog);
+	if (bench.texture_prog) glDeleteProgram (bench.texture_prog);
+}
 static void draw_window (struct window *window) {
+	EGLint n_rects = 0;
+
 	window->color = (window->color + 1) % 256;
-	float c = window->color / 255.0;
-	glClearColor (0.0, c, 0.0, 1.0);
-	glClear (GL_COLOR_BUFFER_BIT);
-	eglSwapBuffers (egl_display, window->egl_surface);
+	if (bench.mode) {
+		pixels_filled += bench_draw (window->width, window->height);
+		if (bench_finished ()) running = 0;
+	} else if (partial_damage) {
+		n_rects = draw_damage (window);
+	} else {
+		float c = window->color / 255.0;
+		glClearColor (0.0, c, 0.0, 1.0);
+		glClear (GL_COLOR_BUFFER_BIT);
+		pixels_filled += (unsigned long long) window->width * window->height;
+	}
+	frame_count++;
+	if (!window->surface) {
+		swap_headless (window);
+		show_fps();
+		return;
+	}
+	if (frame_callback) {
+		// must be requested before eglSwapBuffers, which commits the surface
+		window->frame_callback = wl_surface_frame (window->surface);
+		wl_callback_add_listener (window->frame_callback, &frame_listener, window);
+	}
+#ifdef HAVE_PRESENTATION_TIME
+	if (presentation) request_feedback (window->surface);
+#endif
+	window->commit_ms = now_ms();
+	if (swap_buffers_with_damage && n_rects) {
+		swap_buffers_with_damage (egl_display, window->egl_surface, &window->damage[window->damage_frame % DAMAGE_HISTORY][0][0], n_rects);
+	} else {
+		eglSwapBuffers (egl_display, window->egl_surface);
+	}
 
 	show_fps();
 }
 
+// Reads and dispatches pending events without ever blocking on a round
+// trip; waits up to timeout ms (-1 = forever) for the display fd.
+static int dispatch_events (int timeout) {
+	struct pollfd fds = {
+		.fd = wl_display_get_fd (display),
+		.events = POLLIN
+	};
+	int rv;
+
+	while (wl_display_prepare_read (display) != 0) {
+		wl_display_dispatch_pending (display);
+	}
+	wl_display_flush (display);
+
+	do {
+		rv = poll (&fds, 1, timeout);
+	} while (rv == -1 && errno == EINTR);
+
+	if (rv <= 0) {
+		wl_display_cancel_read (display);
+	} else if (wl_display_read_events (display) == -1) {
+		return -1;
+	}
+
+	return wl_display_dispatch_pending (display);
+}
+
 void load_env() {
 	const char *swap_str = getenv("SWAP_INTERVAL");
 	const char *width_str = getenv("WIDTH");
 	const char *height_str = getenv("HEIGHT");
+	const char *frame_callback_str = getenv("FRAME_CALLBACK");
+	const char *presentation_str = getenv("PRESENTATION");
+	const char *damage_str = getenv("DAMAGE");
+	const char *backend_str = getenv("BACKEND");
+	const char *frames_str = getenv("FRAMES");
+	const char *layers_str = getenv("LAYERS");
+	const char *texture_size_str = getenv("TEXTURE_SIZE");
+	const char *bench_frames_str = getenv("BENCH_FRAMES");
 
 	if (swap_str) {
 		swap_interval = atoi(swap_str);
@@ -166,33 +988,176 @@ void load_env() {
 	if (height_str) {
 		height = atoi(height_str);
 	}
+
+	if (frame_callback_str) {
+		frame_callback = atoi(frame_callback_str) != 0;
+	}
+
+	if (presentation_str) {
+		presentation_feedback = atoi(presentation_str) != 0;
+	}
+
+	if (damage_str) {
+		partial_damage = atoi(damage_str) != 0;
+	}
+
+	if (backend_str) {
+		const int count = sizeof(backend_names) / sizeof(backend_names[0]);
+		int i;
+		for (i = 0; i < count; i++) {
+			if (!strcmp (backend_str, backend_names[i])) break;
+		}
+		if (i < count) {
+			backend = i;
+		} else {
+			printf("unknown backend %s, using wayland (wayland, surfaceless, pbuffer or gbm)\n", backend_str);
+		}
+	}
+
+	// FRAMES=<n> exits after n frames
+	if (frames_str) {
+		frame_limit = strtoul (frames_str, NULL, 10);
+	}
+
+	bench.mode = getenv("BENCH");
+
+	if (layers_str) {
+		bench.layers = atoi(layers_str);
+	}
+
+	if (texture_size_str) {
+		bench.texture_size = atoi(texture_size_str);
+	}
+
+	if (bench_frames_str) {
+		bench.frames_per_case = strtoul (bench_frames_str, NULL, 10);
+		if (bench.frames_per_case < 2) bench.frames_per_case = 2;
+	}
+}
+
+static void load_egl_extensions () {
+	const char *extensions = eglQueryString (egl_display, EGL_EXTENSIONS);
+
+	if (!extensions) return;
+
+	has_buffer_age = strstr (extensions, "EGL_EXT_buffer_age") != NULL;
+	if (strstr (extensions, "EGL_KHR_swap_buffers_with_damage")) {
+		swap_buffers_with_damage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC) eglGetProcAddress ("eglSwapBuffersWithDamageKHR");
+	} else if (strstr (extensions, "EGL_EXT_swap_buffers_with_damage")) {
+		swap_buffers_with_damage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC) eglGetProcAddress ("eglSwapBuffersWithDamageEXT");
+	}
+	printf("buffer age: %s, swap with damage: %s\n", has_buffer_age ? "yes" : "no", swap_buffers_with_damage ? "yes" : "no");
+}
+
+static void stop (int signum) {
+	running = 0;
+}
+
+static void show_summary (double start_ms) {
+	const double seconds = (now_ms() - start_ms) / 1000.0;
+
+	if (seconds > 0) {
+		printf("%s: %lu frames in %.2f s, %.2f FPS, fill %.1f MB/s\n", backend_names[backend], frame_count, seconds,
+		       frame_count / seconds, pixels_filled * bytes_per_pixel / seconds / 1000000.0);
+	}
+}
+
+static int run_headless () {
+	struct window window;
+	double start_ms;
+	int rv = 1;
+
+	signal (SIGINT, stop);
+	signal (SIGTERM, stop);
+
+	if (create_headless_window (&window, width, height)) {
+		load_egl_extensions();
+		printf("width: %u\nheight: %u\n", window.width, window.height);
+		if (bench.mode && !bench_init ()) {
+			delete_headless_window (&window);
+			return 1;
+		}
+		start_ms = now_ms();
+		while (running && (!frame_limit || frame_count < frame_limit)) {
+			draw_window (&window);
+		}
+		show_summary (start_ms);
+		if (bench.mode) bench_term ();
+		rv = 0;
+	}
+	delete_headless_window (&window);
+	return rv;
 }
 
 int main () {
 	load_env();
 
+	if (backend != BACKEND_WAYLAND) {
+		return run_headless ();
+	}
+
 	display = wl_display_connect (NULL);
 	struct wl_registry *registry = wl_display_get_registry (display);
 	wl_registry_add_listener (registry, &registry_listener, NULL);
 	wl_display_roundtrip (display);
+#ifdef HAVE_XDG_SHELL
+	if (wm_base) {
+		xdg_wm_base_add_listener (wm_base, &wm_base_listener, NULL);
+	}
+	printf("shell: %s\n", wm_base ? "xdg_wm_base" : "wl_shell");
+#endif
+#ifdef HAVE_PRESENTATION_TIME
+	if (presentation) {
+		// second roundtrip delivers the clock_id event
+		wp_presentation_add_listener (presentation, &presentation_listener, NULL);
+		wl_display_roundtrip (display);
+	}
+	printf("presentation feedback: %s\n", presentation ? "on" : "off");
+#endif
 	
 	egl_display = eglGetDisplay (display);
 	eglInitialize (egl_display, NULL, NULL);
+	load_egl_extensions();
 	
 	struct window window;
 	create_window (&window, width, height);
-	printf("width: %u\nheight: %u\n", width, height);
+	printf("width: %u\nheight: %u\n", window.width, window.height);
+	if (bench.mode && !bench_init ()) {
+		running = 0;
+	}
 
 	EGLBoolean rv = eglSwapInterval(egl_display, swap_interval);
 	printf("%s = eglSwapInterval(%p, %d)\n", rv == EGL_TRUE ? "EGL_TRUE" : "EGL_FALSE", egl_display, swap_interval);
+	printf("frame callback: %s\n", frame_callback ? "on" : "off");
 
-	while (running) {
-		wl_display_dispatch_pending (display);
-		wl_display_roundtrip (display);
-		draw_window (&window);
+	// With FRAME_CALLBACK=1 (default) rendering is paced by the compositor's
+	// frame events; otherwise the loop free-runs and only polls for events.
+	double start_ms = now_ms();
+	while (running && (!frame_limit || frame_count < frame_limit)) {
+		if (dispatch_events (window.frame_callback ? -1 : 0) == -1) {
+			fprintf (stderr, "wayland connection lost (%d)\n", wl_display_get_error (display));
+			break;
+		}
+
+		if (!window.frame_callback) {
+			draw_window (&window);
+		}
 	}
+	show_summary (start_ms);
+	if (bench.mode) bench_term ();
 	
 	delete_window (&window);
+#ifdef HAVE_PRESENTATION_TIME
+	if (presentation) {
+		for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+			if (feedback_slots[i].feedback) feedback_release (&feedback_slots[i]);
+		}
+		wp_presentation_destroy (presentation);
+	}
+#endif
+#ifdef HAVE_XDG_SHELL
+	if (wm_base) xdg_wm_base_destroy (wm_base);
+#endif
 	eglTerminate (egl_display);
 	wl_display_disconnect (display);
 	return 0;
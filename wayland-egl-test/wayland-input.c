@@ -27,6 +27,12 @@
 
 //    GL: gcc -o wayland-input wayland-input.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl xkbcommon)
 // epoxy: gcc -DHAVE_EPOXY -o wayland-input wayland-input.c $(pkg-config --cflags --libs epoxy wayland-client wayland-egl xkbcommon)
+//
+// xdg-shell (preferred over wl_shell when the compositor offers xdg_wm_base):
+//   X=$(pkg-config --variable=pkgdatadir wayland-protocols)/stable/xdg-shell/xdg-shell.xml
+//   wayland-scanner client-header $X xdg-shell-client-protocol.h
+//   wayland-scanner private-code $X xdg-shell-protocol.c
+//   gcc -DHAVE_XDG_SHELL -I. -o wayland-input wayland-input.c xdg-shell-protocol.c $(pkg-config --cflags --libs wayland-client wayland-egl glesv2 egl xkbcommon)
 
 
 #ifdef HAVE_EPOXY
@@ -38,13 +44,22 @@
 #include <assert.h>
 #include <wayland-client.h>
 #include <wayland-egl.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <xkbcommon/xkbcommon.h>
+#include <signal.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <poll.h>
+#include <time.h>
 #include <errno.h>
+#ifdef HAVE_XDG_SHELL
+#  include "xdg-shell-client-protocol.h"
+#endif
 
 #define WIDTH 256
 #define HEIGHT 256
@@ -53,19 +68,97 @@ static struct wl_display *display;
 static int fd;
 static struct wl_compositor *compositor = NULL;
 static struct wl_shell *shell = NULL;
+#ifdef HAVE_XDG_SHELL
+static struct xdg_wm_base *wm_base = NULL;
+#endif
 static struct wl_seat *seat = NULL;
 static EGLDisplay egl_display;
 static struct xkb_context *xkb_context;
 static struct xkb_keymap *keymap = NULL;
 static struct xkb_state *xkb_state = NULL;
 static char running = 1;
+// set by input (or the animation timer), cleared once a frame is drawn
+static char needs_redraw = 1;
+// ANIMATE=<fps> keeps redrawing at that rate, 0 (default) only redraws on input
+static int animate_fps = 0;
+
+// Input-to-photon latency: a key press is stamped on receipt, the next
+// frame drawn carries that stamp and the latency is taken when the frame
+// callback for that frame arrives.
+#define LATENCY_BIN_US 500
+#define LATENCY_BINS 200
+
+static uint64_t pending_input_us = 0;
+static struct {
+	unsigned long count;
+	uint64_t min_us, max_us;
+	unsigned long bins[LATENCY_BINS + 1];
+} input_latency;
+
+static uint64_t now_us () {
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void record_input_latency (uint64_t input_us, uint64_t present_us) {
+	const uint64_t latency_us = present_us - input_us;
+	const uint64_t bin = latency_us / LATENCY_BIN_US;
+
+	if (!input_latency.count || latency_us < input_latency.min_us) input_latency.min_us = latency_us;
+	if (latency_us > input_latency.max_us) input_latency.max_us = latency_us;
+	input_latency.bins[bin < LATENCY_BINS ? bin : LATENCY_BINS]++;
+	input_latency.count++;
+}
+
+static double latency_percentile (double p) {
+	const unsigned long target = input_latency.count * p;
+	unsigned long count = 0;
+	int i;
+
+	for (i = 0; i < LATENCY_BINS; i++) {
+		count += input_latency.bins[i];
+		if (count > target) break;
+	}
+	// bin upper edge, but never above the largest sample seen
+	return ((i + 1) * LATENCY_BIN_US < input_latency.max_us) ? (i + 1) * LATENCY_BIN_US / 1000.0 : input_latency.max_us / 1000.0;
+}
+
+static void show_input_latency () {
+	if (!input_latency.count) return;
+
+	printf ("input latency: %lu samples, min %.2f ms p50 %.2f ms p90 %.2f ms p99 %.2f ms max %.2f ms\n",
+		input_latency.count, input_latency.min_us / 1000.0,
+		latency_percentile (0.50), latency_percentile (0.90), latency_percentile (0.99),
+		input_latency.max_us / 1000.0);
+	for (int i = 0; i <= LATENCY_BINS; i++) {
+		if (input_latency.bins[i]) {
+			printf ("  %s%6.1f ms: %lu\n", i == LATENCY_BINS ? ">" : "<", (i + (i < LATENCY_BINS)) * LATENCY_BIN_US / 1000.0, input_latency.bins[i]);
+		}
+	}
+}
+
+// an fd watched by the main loop's epoll set
+struct watch {
+	int fd;
+	void (*handler) (struct watch *watch, uint32_t events);
+};
 
 struct window {
 	EGLContext egl_context;
 	struct wl_surface *surface;
 	struct wl_shell_surface *shell_surface;
+#ifdef HAVE_XDG_SHELL
+	struct xdg_surface *xdg_surface;
+	struct xdg_toplevel *xdg_toplevel;
+	int32_t pending_width, pending_height;
+	char configured;
+#endif
 	struct wl_egl_window *egl_window;
+	int32_t width, height;
 	EGLSurface egl_surface;
+	struct wl_callback *frame_callback;
+	uint64_t frame_input_us;
 	int color;
 };
 
@@ -81,6 +174,7 @@ static void pointer_motion (void *data, struct wl_pointer *pointer, uint32_t tim
 }
 static void pointer_button (void *data, struct wl_pointer *pointer, uint32_t serial, uint32_t time, uint32_t button, uint32_t state) {
 	printf ("pointer button (button %d, state %d)\n", button, state);
+	if (state == WL_POINTER_BUTTON_STATE_PRESSED) needs_redraw = 1;
 }
 static void pointer_axis (void *data, struct wl_pointer *pointer, uint32_t time, uint32_t axis, wl_fixed_t value) {
 	printf ("pointer axis\n");
@@ -104,6 +198,9 @@ static void keyboard_leave (void *data, struct wl_keyboard *keyboard, uint32_t s
 }
 static void keyboard_key (void *data, struct wl_keyboard *keyboard, uint32_t serial, uint32_t time, uint32_t key, uint32_t state) {
 	if (state == WL_KEYBOARD_KEY_STATE_PRESSED) {
+		needs_redraw = 1;
+		// only the oldest unanswered press counts until a frame shows it
+		if (!pending_input_us) pending_input_us = now_us();
 		xkb_keysym_t keysym = xkb_state_key_get_one_sym (xkb_state, key+8);
 		uint32_t utf32 = xkb_keysym_to_utf32 (keysym);
 		if (utf32) {
@@ -160,6 +257,11 @@ static void registry_add_object (void *data, struct wl_registry *registry, uint3
 	else if (!strcmp(interface,"wl_shell")) {
 		shell = wl_registry_bind (registry, name, &wl_shell_interface, 1);
 	}
+#ifdef HAVE_XDG_SHELL
+	else if (!strcmp(interface,"xdg_wm_base")) {
+		wm_base = wl_registry_bind (registry, name, &xdg_wm_base_interface, 1);
+	}
+#endif
 	else if (!strcmp(interface,"wl_seat")) {
 		seat = wl_registry_bind (registry, name, &wl_seat_interface, 1);
 		wl_seat_add_listener (seat, &seat_listener, NULL);
@@ -170,18 +272,57 @@ static void registry_remove_object (void *data, struct wl_registry *registry, ui
 }
 static struct wl_registry_listener registry_listener = {&registry_add_object, &registry_remove_object};
 
+// a new size needs a frame at that size, input may not come for a while
+static void resize_window (struct window *window, int32_t width, int32_t height) {
+	if (width == window->width && height == window->height) return;
+	wl_egl_window_resize (window->egl_window, width, height, 0, 0);
+	window->width = width;
+	window->height = height;
+	needs_redraw = 1;
+}
+
 static void shell_surface_ping (void *data, struct wl_shell_surface *shell_surface, uint32_t serial) {
 	wl_shell_surface_pong (shell_surface, serial);
 }
 static void shell_surface_configure (void *data, struct wl_shell_surface *shell_surface, uint32_t edges, int32_t width, int32_t height) {
 	struct window *window = data;
-	wl_egl_window_resize (window->egl_window, width, height, 0, 0);
+	resize_window (window, width, height);
 }
 static void shell_surface_popup_done (void *data, struct wl_shell_surface *shell_surface) {
 	
 }
 static struct wl_shell_surface_listener shell_surface_listener = {&shell_surface_ping, &shell_surface_configure, &shell_surface_popup_done};
 
+#ifdef HAVE_XDG_SHELL
+static void wm_base_ping (void *data, struct xdg_wm_base *wm_base, uint32_t serial) {
+	xdg_wm_base_pong (wm_base, serial);
+}
+static struct xdg_wm_base_listener wm_base_listener = {&wm_base_ping};
+
+// toplevel configure only stores the new state, it is applied and acked
+// atomically in xdg_surface.configure before the next commit
+static void xdg_toplevel_configure (void *data, struct xdg_toplevel *toplevel, int32_t width, int32_t height, struct wl_array *states) {
+	struct window *window = data;
+	window->pending_width = width;
+	window->pending_height = height;
+}
+static void xdg_toplevel_close (void *data, struct xdg_toplevel *toplevel) {
+	running = 0;
+}
+static struct xdg_toplevel_listener xdg_toplevel_listener = {&xdg_toplevel_configure, &xdg_toplevel_close};
+
+static void xdg_surface_configure (void *data, struct xdg_surface *xdg_surface, uint32_t serial) {
+	struct window *window = data;
+	// 0x0 means the client picks its own size
+	if (window->pending_width > 0 && window->pending_height > 0) {
+		resize_window (window, window->pending_width, window->pending_height);
+	}
+	xdg_surface_ack_configure (xdg_surface, serial);
+	window->configured = 1;
+}
+static struct xdg_surface_listener xdg_surface_listener = {&xdg_surface_configure};
+#endif
+
 static void create_window (struct window *window, int32_t width, int32_t height) {
 	eglBindAPI (EGL_OPENGL_ES_API);
 	EGLint attributes[] = {
@@ -196,30 +337,136 @@ static void create_window (struct window *window, int32_t width, int32_t height)
 	window->egl_context = eglCreateContext (egl_display, config, EGL_NO_CONTEXT, contextAttributes);
 	
 	window->surface = wl_compositor_create_surface (compositor);
-	window->shell_surface = wl_shell_get_shell_surface (shell, window->surface);
-	wl_shell_surface_add_listener (window->shell_surface, &shell_surface_listener, window);
-	wl_shell_surface_set_toplevel (window->shell_surface);
 	window->egl_window = wl_egl_window_create (window->surface, width, height);
+	window->width = width;
+	window->height = height;
+	window->shell_surface = NULL;
+#ifdef HAVE_XDG_SHELL
+	window->xdg_surface = NULL;
+	window->xdg_toplevel = NULL;
+	if (wm_base) {
+		window->configured = 0;
+		window->xdg_surface = xdg_wm_base_get_xdg_surface (wm_base, window->surface);
+		xdg_surface_add_listener (window->xdg_surface, &xdg_surface_listener, window);
+		window->xdg_toplevel = xdg_surface_get_toplevel (window->xdg_surface);
+		xdg_toplevel_add_listener (window->xdg_toplevel, &xdg_toplevel_listener, window);
+		xdg_toplevel_set_title (window->xdg_toplevel, "wayland-input");
+		// initial commit without a buffer, no content may be attached before
+		// the first configure has been acked
+		wl_surface_commit (window->surface);
+		while (!window->configured && wl_display_dispatch (display) != -1);
+	}
+	else
+#endif
+	{
+		window->shell_surface = wl_shell_get_shell_surface (shell, window->surface);
+		wl_shell_surface_add_listener (window->shell_surface, &shell_surface_listener, window);
+		wl_shell_surface_set_toplevel (window->shell_surface);
+	}
 	window->egl_surface = eglCreateWindowSurface (egl_display, config, window->egl_window, NULL);
 	eglMakeCurrent (egl_display, window->egl_surface, window->egl_surface, window->egl_context);
+	window->frame_callback = NULL;
+	window->frame_input_us = 0;
 	window->color = 0;
 }
 static void delete_window (struct window *window) {
+	if (window->frame_callback) wl_callback_destroy (window->frame_callback);
 	eglDestroySurface (egl_display, window->egl_surface);
 	wl_egl_window_destroy (window->egl_window);
-	wl_shell_surface_destroy (window->shell_surface);
+#ifdef HAVE_XDG_SHELL
+	if (window->xdg_toplevel) xdg_toplevel_destroy (window->xdg_toplevel);
+	if (window->xdg_surface) xdg_surface_destroy (window->xdg_surface);
+#endif
+	if (window->shell_surface) wl_shell_surface_destroy (window->shell_surface);
 	wl_surface_destroy (window->surface);
 	eglDestroyContext (egl_display, window->egl_context);
 }
+static void frame_done (void *data, struct wl_callback *callback, uint32_t time) {
+	struct window *window = data;
+	if (window->frame_input_us) {
+		record_input_latency (window->frame_input_us, now_us());
+		window->frame_input_us = 0;
+	}
+	wl_callback_destroy (callback);
+	window->frame_callback = NULL;
+}
+static struct wl_callback_listener frame_listener = {&frame_done};
+
 static void draw_window (struct window *window) {
 	window->color = (window->color + 1) % 256;
 	float c = window->color / 255.0;
 	glClearColor (0.0, c, 0.0, 1.0);
 	glClear (GL_COLOR_BUFFER_BIT);
+	// no new frame until the compositor has consumed this one
+	window->frame_callback = wl_surface_frame (window->surface);
+	wl_callback_add_listener (window->frame_callback, &frame_listener, window);
+	window->frame_input_us = pending_input_us;
+	pending_input_us = 0;
 	eglSwapBuffers (egl_display, window->egl_surface);
+	needs_redraw = 0;
+}
+
+static void display_handler (struct watch *watch, uint32_t events) {
+	if (events & (EPOLLERR | EPOLLHUP)) {
+		running = 0;
+	}
+}
+
+static void timer_handler (struct watch *watch, uint32_t events) {
+	uint64_t expirations;
+	if (read (watch->fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+		needs_redraw = 1;
+	}
+}
+
+static void signal_handler (struct watch *watch, uint32_t events) {
+	struct signalfd_siginfo info;
+	if (read (watch->fd, &info, sizeof(info)) == sizeof(info)) {
+		printf ("signal %u\n", info.ssi_signo);
+		running = 0;
+	}
+}
+
+static int add_watch (int epoll_fd, struct watch *watch) {
+	struct epoll_event event = {
+		.events = EPOLLIN,
+		.data.ptr = watch
+	};
+	return epoll_ctl (epoll_fd, EPOLL_CTL_ADD, watch->fd, &event);
+}
+static int set_watch_events (int epoll_fd, struct watch *watch, uint32_t events) {
+	struct epoll_event event = {
+		.events = events,
+		.data.ptr = watch
+	};
+	return epoll_ctl (epoll_fd, EPOLL_CTL_MOD, watch->fd, &event);
+}
+
+static double timespec_ms (const struct timespec *ts) {
+	return ts->tv_sec * 1000.0 + ts->tv_nsec / 1000000.0;
+}
+static double timeval_ms (const struct timeval *tv) {
+	return tv->tv_sec * 1000.0 + tv->tv_usec / 1000.0;
+}
+
+static void show_cpu_usage (const struct timespec *start, unsigned long frames) {
+	struct rusage usage;
+	struct timespec now;
+
+	getrusage (RUSAGE_SELF, &usage);
+	clock_gettime (CLOCK_MONOTONIC, &now);
+
+	const double wall_ms = timespec_ms (&now) - timespec_ms (start);
+	const double cpu_ms = timeval_ms (&usage.ru_utime) + timeval_ms (&usage.ru_stime);
+	printf ("frames: %lu in %.1f s, cpu: %.1f ms (%.2f%%), wakeups: %ld voluntary %ld involuntary\n",
+		frames, wall_ms / 1000.0, cpu_ms, wall_ms > 0 ? 100.0 * cpu_ms / wall_ms : 0.0,
+		usage.ru_nvcsw, usage.ru_nivcsw);
 }
 
 int main () {
+	const char *animate_str = getenv ("ANIMATE");
+	if (animate_str) animate_fps = atoi (animate_str);
+
 	xkb_context = xkb_context_new (XKB_CONTEXT_NO_FLAGS);
 	assert(xkb_context != NULL);
 
@@ -233,6 +480,12 @@ int main () {
 
 	wl_registry_add_listener (registry, &registry_listener, NULL);
 	wl_display_roundtrip (display);
+#ifdef HAVE_XDG_SHELL
+	if (wm_base) {
+		xdg_wm_base_add_listener (wm_base, &wm_base_listener, NULL);
+	}
+	printf("shell: %s\n", wm_base ? "xdg_wm_base" : "wl_shell");
+#endif
 	
 	egl_display = eglGetDisplay (display);
 
@@ -246,36 +499,115 @@ int main () {
 	
 	struct window window;
 	create_window (&window, WIDTH, HEIGHT);
-	
+	// pacing comes from our own frame callbacks, eglSwapBuffers must not
+	// block waiting for one and hold up input dispatch
+	eglSwapInterval (egl_display, 0);
+
+	int epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+	assert(epoll_fd != -1);
+
+	struct watch display_watch = { fd, display_handler };
+	add_watch (epoll_fd, &display_watch);
+
+	sigset_t signals;
+	sigemptyset (&signals);
+	sigaddset (&signals, SIGINT);
+	sigaddset (&signals, SIGTERM);
+	// ignored signals are dropped even when blocked, and a shell starts
+	// background jobs with SIGINT ignored
+	signal (SIGINT, SIG_DFL);
+	signal (SIGTERM, SIG_DFL);
+	sigprocmask (SIG_BLOCK, &signals, NULL);
+	struct watch signal_watch = { signalfd (-1, &signals, SFD_CLOEXEC), signal_handler };
+	add_watch (epoll_fd, &signal_watch);
+
+	struct watch timer_watch = { -1, timer_handler };
+	if (animate_fps > 0) {
+		const long period_ns = 1000000000L / animate_fps;
+		struct itimerspec spec = {
+			.it_interval = { period_ns / 1000000000L, period_ns % 1000000000L },
+			.it_value = { period_ns / 1000000000L, period_ns % 1000000000L }
+		};
+		timer_watch.fd = timerfd_create (CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+		timerfd_settime (timer_watch.fd, 0, &spec, NULL);
+		add_watch (epoll_fd, &timer_watch);
+	}
+
+	struct timespec start;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+	unsigned long frames = 0;
+	char flush_pending = 0;
+
+	// Sleeps in epoll_wait until the display, a timer or a signal has
+	// something for us; a frame is drawn only when input or the animation
+	// asked for one and the previous frame has been consumed.
 	while (running) {
-	    int rv;
-#ifndef SKIP_READING_EVENTS
-	    while (wl_display_prepare_read(display) < 0) {
-		wl_display_dispatch_pending(display);
+	    struct epoll_event events[4];
+	    int n;
+
+	    while (wl_display_prepare_read (display) != 0) {
+		wl_display_dispatch_pending (display);
+	    }
+	    // a full socket buffer keeps the rest of the requests queued: also
+	    // wait for the socket to become writable and flush again then
+	    if (wl_display_flush (display) == -1) {
+		if (errno != EAGAIN) {
+		    wl_display_cancel_read (display);
+		    break;
+		}
+		if (!flush_pending) {
+		    set_watch_events (epoll_fd, &display_watch, EPOLLIN | EPOLLOUT);
+		    flush_pending = 1;
+		}
+	    } else if (flush_pending) {
+		set_watch_events (epoll_fd, &display_watch, EPOLLIN);
+		flush_pending = 0;
 	    }
 
-	    wl_display_flush(display);
+	    if (needs_redraw && !window.frame_callback) {
+		wl_display_cancel_read (display);
+		draw_window (&window);
+		frames++;
+		continue;
+	    }
 
 	    do {
-	        struct pollfd fds = {
-	    	    .fd = fd,
-		    .events = POLLIN
-	        };
+		n = epoll_wait (epoll_fd, events, 4, -1);
+	    } while (n == -1 && errno == EINTR);
 
-		rv = poll(&fds, 1, 1);
-	    } while(rv == -1 && rv == EINTR);
+	    if (n == -1) {
+		wl_display_cancel_read (display);
+		break;
+	    }
 
-	    if (rv <= 0) {
-		wl_display_cancel_read(display);
+	    char display_readable = 0;
+	    for (int i = 0; i < n; i++) {
+		struct watch *watch = events[i].data.ptr;
+		if (watch == &display_watch && (events[i].events & EPOLLIN)) {
+		    display_readable = 1;
+		}
+		watch->handler (watch, events[i].events);
+	    }
+
+	    if (display_readable) {
+		if (wl_display_read_events (display) == -1) break;
 	    } else {
-		wl_display_read_events(display);
+		wl_display_cancel_read (display);
 	    }
-#endif
-	    wl_display_dispatch_pending (display);
-	    draw_window (&window);
+	    if (wl_display_dispatch_pending (display) == -1) break;
 	}
+
+	show_cpu_usage (&start, frames);
+	show_input_latency ();
+
+	if (timer_watch.fd != -1) close (timer_watch.fd);
+	close (signal_watch.fd);
+	close (epoll_fd);
 	
 	delete_window (&window);
+#ifdef HAVE_XDG_SHELL
+	if (wm_base) xdg_wm_base_destroy (wm_base);
+#endif
 	eglTerminate (egl_display);
 	wl_display_disconnect (display);
 	return 0;